@@ -11,15 +11,8 @@ inline constexpr auto kSequenceCycles = kCpuFrequency / 512;
 
 Apu::Apu()
 {
-    events.sequence = [this](u64 late)
-    {
-        sequence<0>(late);
-    };
-
-    events.sample = [this](u64 late)
-    {
-        sample(late);
-    };
+    events.sequence.bind<&Apu::sequence>(this);
+    events.sample.bind<&Apu::sample>(this);
 }
 
 void Apu::init()
@@ -50,18 +43,10 @@ void Apu::onOverflow(uint timer, uint ticks)
     }
 }
 
-template<uint kStep>
 void Apu::sequence(u64 late)
 {
-    static_assert(!(kStep == 1 || kStep == 3 || kStep == 5));
-
-    switch (kStep)
+    switch (step)
     {
-    case 1:
-    case 3:
-    case 5:
-        break;
-
     case 2:
     case 6:
         square1.tickSweep();
@@ -86,22 +71,11 @@ void Apu::sequence(u64 late)
         break;
     }
 
-    if constexpr (kStep == 0 || kStep == 2 || kStep == 4)
-    {
-        events.sequence = [this](u64 late)
-        {
-            sequence<(kStep + 2) % 8>(late);
-        };
-        scheduler.insert(events.sequence, 2 * kSequenceCycles - late);
-    }
-    else
-    {
-        events.sequence = [this](u64 late)
-        {
-            sequence<(kStep + 1) % 8>(late);
-        };
-        scheduler.insert(events.sequence, 1 * kSequenceCycles - late);
-    }
+    uint steps = step < 6 ? 2 : 1;
+
+    step = (step + steps) % 8;
+
+    scheduler.insert(events.sequence, steps * kSequenceCycles - late);
 }
 
 void Apu::sample(u64 late)
@@ -25,7 +25,6 @@ class Apu
     SoundBias bias;
 
 private:
-    template<uint kStep>
     void sequence(u64 late);
     void sample(u64 late);
 
@@ -34,6 +33,8 @@ class Apu
         Event sequence;
         Event sample;
     } events;
+
+    uint step = 0;
 };
 
 inline Apu apu;
@@ -54,7 +54,7 @@ void Channel::init(bool enabled)
     length.init();
 
     timer = 0;
-    since = scheduler.now;
+    since = scheduler.now();
 }
 
 void Channel::initSweep()
@@ -72,13 +72,13 @@ void Channel::initEnvelope()
 
 uint Channel::run()
 {
-    timer += scheduler.now - since;
+    timer += scheduler.now() - since;
 
     uint period = this->period();
     uint ticks  = timer / period;
 
     timer %= period;
-    since = scheduler.now;
+    since = scheduler.now();
 
     return ticks;
 }
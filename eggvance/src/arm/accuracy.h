@@ -0,0 +1,3 @@
+#pragma once
+
+enum class Accuracy { Accurate, Balanced, Fast };
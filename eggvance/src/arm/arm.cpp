@@ -1,85 +1,258 @@
 #include "arm.h"
 
+#include <algorithm>
+#include <cstddef>
+
 #include "decode.h"
+#include "recompiler.h"
+#include "base/config.h"
 #include "dma/dma.h"
+#include "ppu/ppu.h"
 #include "scheduler/scheduler.h"
 #include "timer/timer.h"
 
 Arm::Arm()
 {
-    interrupt.delay = [this](u64 late)
-    {
-        state |= State::Irq;
-    };
+    #if defined(__GNUC__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Winvalid-offsetof"
+    #endif
+    static_assert(offsetof(Arm, regs)   ==   0);
+    static_assert(offsetof(Arm, cpsr)   ==  64);
+    static_assert(offsetof(Arm, state)  == 100);
+    static_assert(offsetof(Arm, pipe)   == 104);
+    static_assert(offsetof(Arm, target) == 120);
+    static_assert(offsetof(Arm, instructions) == 128);
+    #if defined(__GNUC__)
+    #pragma GCC diagnostic pop
+    #endif
+
+    interrupt.delay.bind<&Arm::onInterruptDelay>(this);
+    slice.bind<&Arm::onSlice>(this);
+
+    initBanks();
 }
 
 void Arm::init()
 {
+    mapPages();
     flushWord();
     pc += 4;
+
+    switch (Accuracy(config.accuracy))
+    {
+    case Accuracy::Balanced: state |= State::Balanced; break;
+    case Accuracy::Fast:     state |= State::Fast; break;
+
+    default:
+        break;
+    }
+
+    if (profiler.isActive())
+        state |= State::Profile;
 }
 
 void Arm::run(u64 cycles)
 {
     target += cycles;
 
-    while (scheduler.now < target)
+    if (scheduler.now() >= target)
+        return;
+
+    scheduler.insert(slice, target - scheduler.now());
+
+    while (!(state & State::Exit))
     {
         switch (state)
         {
-        SHELL_CASE16(0, dispatch<kLabel>())
+        SHELL_CASE16( 0, dispatch<kLabel>())
+        SHELL_CASE16(32, dispatch<kLabel>())
+        SHELL_CASE16(64, dispatch<kLabel>())
+        #if PROFILER_ENABLED
+        SHELL_CASE16(16, dispatch<kLabel>())
+        SHELL_CASE16(48, dispatch<kLabel>())
+        SHELL_CASE16(80, dispatch<kLabel>())
+        #endif
 
         default:
             SHELL_UNREACHABLE;
             break;
         }
     }
+    state &= ~State::Exit;
+}
+
+void Arm::onSlice(u64 late)
+{
+    state |= State::Exit;
+}
+
+template<typename Block>
+SHELL_INLINE void Arm::skipIdleLoop(const Block& block)
+{
+    if (block.idle && block.addr == idle_loop)
+    {
+        u64 cycles = std::min(scheduler.next, ppu.nextTransition()) - scheduler.now();
+
+        idle_cycles += cycles;
+        scheduler.run(cycles);
+    }
+    idle_loop = block.idle ? block.addr : 0;
+}
+
+template<uint kState>
+SHELL_INLINE void Arm::stepThumb()
+{
+    u16 instr = pipe[0];
+
+    auto entry = blocks_thumb.next(pc - 4);
+    if (!entry)
+        entry = compileThumb(pc - 4);
+
+    if (entry && entry == blocks_thumb.block().begin())
+    {
+        if (config.idle_loops)
+            skipIdleLoop(blocks_thumb.block());
+
+        if ((config.jit || recompiler.isLoaded()) && !(state & State::Profile) && jit.run(blocks_thumb))
+            return;
+    }
+
+    pipe[0] = pipe[1];
+
+    if (entry)
+    {
+        pipe[1] = entry[2].instr;
+
+        if (u64 fetch = blocks_thumb.fetch())
+            tickRam<accuracy(kState)>(fetch);
+        else
+            tickRom<accuracy(kState)>(pc, waitcnt.waitHalf(pc, pipe.access));
+
+        pipe.access = Access::Sequential;
+
+        auto handler = entry->instr == instr && state == kState
+            ? entry->handler
+            : instr_thumb[hashThumb(instr)];
+
+        handler(*this, instr);
+    }
+    else
+    {
+        idle_loop = 0;
+
+        pipe[1] = fetch<u16>(pc, pipe.access);
+        pipe.access = Access::Sequential;
+
+        instr_thumb[hashThumb(instr)](*this, instr);
+    }
+}
+
+template<uint kState>
+SHELL_INLINE void Arm::stepArm()
+{
+    u32 instr = pipe[0];
+
+    auto entry = blocks_arm.next(pc - 8);
+    if (!entry)
+        entry = compileArm(pc - 8);
+
+    if (entry && entry == blocks_arm.block().begin())
+    {
+        if (config.idle_loops)
+            skipIdleLoop(blocks_arm.block());
+
+        if ((config.jit || recompiler.isLoaded()) && !(state & State::Profile) && jit.run(blocks_arm))
+            return;
+    }
+
+    pipe[0] = pipe[1];
+
+    if (entry)
+    {
+        pipe[1] = entry[2].instr;
+
+        if (u64 fetch = blocks_arm.fetch())
+            tickRam<accuracy(kState)>(fetch);
+        else
+            tickRom<accuracy(kState)>(pc, waitcnt.waitWord(pc, pipe.access));
+
+        pipe.access = Access::Sequential;
+
+        auto handler = entry->instr == instr && state == kState
+            ? entry->handler
+            : instr_arm[hashArm(instr)];
+
+        if (cpsr.check(instr >> 28))
+        {
+            handler(*this, instr);
+        }
+    }
+    else
+    {
+        idle_loop = 0;
+
+        if (pc - 8 == Bios::kIrqReturn && isHle())
+        {
+            hleIrqReturn();
+            return;
+        }
+
+        pipe[1] = fetch<u32>(pc, pipe.access);
+        pipe.access = Access::Sequential;
+
+        if (cpsr.check(instr >> 28))
+        {
+            instr_arm[hashArm(instr)](*this, instr);
+        }
+    }
 }
 
 template<uint kState>
 void Arm::dispatch()
 {
-    while (scheduler.now < target && state == kState)
+    while (state == kState)
     {
+        [[maybe_unused]] u64 now = scheduler.now();
+
         if (kState & State::Dma)
         {
+            idle_loop = 0;
             dma.run();
+
+            if (kState & State::Profile)
+                profiler.dma(scheduler.now() - now);
         }
         else if (kState & State::Halt)
         {
-            scheduler.run(std::min(target - scheduler.now, scheduler.next - scheduler.now));
+            scheduler.run(scheduler.countdown);
+
+            if (kState & State::Profile)
+                profiler.halt(scheduler.now() - now);
         }
         else
         {
+            [[maybe_unused]] u32 addr = pc - 2 * cpsr.size();
+            [[maybe_unused]] u32 instr = pipe[0];
+
             if ((kState & State::Irq) && !cpsr.i)
             {
                 interruptHw();
+
+                if (kState & State::Profile)
+                    profiler.interrupt(addr);
             }
             else
             {
                 if (kState & State::Thumb)
-                {
-                    u16 instr = pipe[0];
+                    stepThumb<kState>();
+                else
+                    stepArm<kState>();
 
-                    pipe[0] = pipe[1];
-                    pipe[1] = readHalf(pc, pipe.access);
-                    pipe.access = Access::Sequential;
+                instructions++;
 
-                    std::invoke(instr_thumb[hashThumb(instr)], this, instr);
-                }
-                else
-                {
-                    u32 instr = pipe[0];
-
-                    pipe[0] = pipe[1];
-                    pipe[1] = readWord(pc, pipe.access);
-                    pipe.access = Access::Sequential;
-
-                    if (cpsr.check(instr >> 28))
-                    {
-                        std::invoke(instr_arm[hashArm(instr)], this, instr);
-                    }
-                }
+                if (kState & State::Profile)
+                    profiler.sample(addr, instr, pc - cpsr.size(), lr, kState & State::Thumb ? 2 : 4, scheduler.now() - now);
             }
             pc += cpsr.size();
         }
@@ -89,8 +262,8 @@ void Arm::dispatch()
 void Arm::flushHalf()
 {
     pc &= ~0x1;
-    pipe[0] = readHalf(pc + 0, Access::NonSequential);
-    pipe[1] = readHalf(pc + 2, Access::Sequential);
+    pipe[0] = fetch<u16>(pc + 0, Access::NonSequential);
+    pipe[1] = fetch<u16>(pc + 2, Access::Sequential);
     pipe.access = Access::Sequential;
     pc += 2;
 }
@@ -98,8 +271,8 @@ void Arm::flushHalf()
 void Arm::flushWord()
 {
     pc &= ~0x3;
-    pipe[0] = readWord(pc + 0, Access::NonSequential);
-    pipe[1] = readWord(pc + 4, Access::Sequential);
+    pipe[0] = fetch<u32>(pc + 0, Access::NonSequential);
+    pipe[1] = fetch<u32>(pc + 4, Access::Sequential);
     pipe.access = Access::Sequential;
     pc += 4;
 }
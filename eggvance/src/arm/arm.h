@@ -1,26 +1,43 @@
 #pragma once
 
+#include <memory>
+#include <vector>
+
+#include "accuracy.h"
 #include "bios.h"
+#include "blockcache.h"
 #include "io.h"
+#include "jit.h"
+#include "pagetable.h"
 #include "pipeline.h"
+#include "profiler.h"
 #include "registers.h"
 #include "scheduler/event.h"
 
-class Arm : public Registers
+class alignas(64) Arm : public Registers
 {
 public:
+    friend class ArmBenchmark;
     friend class Dma;
     friend class DmaChannel;
     friend class InterruptEnable;
     friend class InterruptRequest;
     friend class InterruptMaster;
+    friend class Jit;
+    friend class JitTest;
+    friend class Profiler;
+    friend class Recompiler;
 
     enum class State
     {
-        Thumb = 1 << 0,
-        Halt  = 1 << 1,
-        Irq   = 1 << 2,
-        Dma   = 1 << 3
+        Thumb    = 1 << 0,
+        Halt     = 1 << 1,
+        Irq      = 1 << 2,
+        Dma      = 1 << 3,
+        Profile  = 1 << 4,
+        Balanced = 1 << 5,
+        Fast     = 1 << 6,
+        Exit     = 1 << 7
     };
 
     Arm();
@@ -31,11 +48,21 @@ class Arm : public Registers
 
     uint state = 0;
 
+private:
+    // Registers, cpsr, state, pipe and target fill the first two cache lines,
+    // which Arm::Arm checks
+    Pipeline pipe;
+    u64 target = 0;
+
+public:
+    u64 instructions = 0;
+    u64 idle_cycles = 0;
+
 private:
     enum class Shift { Lsl, Lsr, Asr, Ror };
 
-    using Instruction32 = void(Arm::*)(u32);
-    using Instruction16 = void(Arm::*)(u16);
+    using Instruction32 = void(*)(Arm&, u32);
+    using Instruction16 = void(*)(Arm&, u16);
 
     static const std::array<Instruction32, 4096> instr_arm;
     static const std::array<Instruction16, 1024> instr_thumb;
@@ -43,6 +70,38 @@ class Arm : public Registers
     template<uint kHash> static constexpr Instruction32 Arm_Decode();
     template<uint kHash> static constexpr Instruction16 Thumb_Decode();
 
+    template<void(Arm::*kHandler)(u32)>
+    static void Arm_Handler(Arm& arm, u32 instr)
+    {
+        (arm.*kHandler)(instr);
+    }
+
+    template<void(Arm::*kHandler)(u16)>
+    static void Thumb_Handler(Arm& arm, u16 instr)
+    {
+        (arm.*kHandler)(instr);
+    }
+
+    using BlockCacheArm   = BlockCache<u32, Instruction32>;
+    using BlockCacheThumb = BlockCache<u16, Instruction16>;
+
+    template<typename Integral>
+    bool readCode(u32 addr, Integral& instr) const;
+
+    template<typename Integral, typename Instruction, std::size_t kSize>
+    const typename BlockCache<Integral, Instruction>::Entry* compile(BlockCache<Integral, Instruction>& cache, const std::array<Instruction, kSize>& table, u32 addr);
+    const BlockCacheArm::Entry* compileArm(u32 addr);
+    const BlockCacheThumb::Entry* compileThumb(u32 addr);
+    void invalidate(u32 addr);
+
+    Instruction16 fuse(u16 instr, u16 next) const;
+    Instruction32 fuse(u32 instr, u32 next) const;
+    SHELL_INLINE void advanceArm();
+    SHELL_INLINE void advanceThumb();
+
+    template<typename Block>
+    void skipIdleLoop(const Block& block);
+
     template<bool kImmediate> SHELL_INLINE u32 lsl(u32 value, u32 amount, bool flags = true);
     template<bool kImmediate> SHELL_INLINE u32 lsr(u32 value, u32 amount, bool flags = true);
     template<bool kImmediate> SHELL_INLINE u32 asr(u32 value, u32 amount, bool flags = true);
@@ -62,6 +121,11 @@ class Arm : public Registers
     void writeHalf(u32 addr, u16 half, Access access = Access::NonSequential);
     void writeWord(u32 addr, u32 word, Access access = Access::NonSequential);
 
+    template<typename Integral> SHELL_INLINE bool readPage(u32 addr, Access access, Integral& value);
+    template<typename Integral> SHELL_INLINE bool writePage(u32 addr, Integral value);
+    SHELL_INLINE u32* transferPage(u32 addr, uint count, bool write, u64& cycles);
+    template<typename Integral> SHELL_INLINE Integral fetch(u32 addr, Access access);
+
     u8 readIo(u32 addr);
     void writeIo(u32 addr, u8 byte);
 
@@ -71,8 +135,25 @@ class Arm : public Registers
     u32 readByteSignEx(u32 addr, Access access = Access::NonSequential);
     u32 readHalfSignEx(u32 addr, Access access = Access::NonSequential);
 
+    void onSlice(u64 late);
+    void onInterruptDelay(u64 late);
+
+    enum class Bank { Def, Fiq, Irq, Svc, Abt, Und };
+
+    static Bank modeToBank(Psr::Mode mode);
+
+    void initBanks();
+    void switchMode(Psr::Mode mode);
+
+    static constexpr Accuracy accuracy(uint state)
+    {
+        return Accuracy((state >> 5) & 0x3);
+    }
+
     template<uint kState> 
     void dispatch();
+    template<uint kState> SHELL_INLINE void stepArm();
+    template<uint kState> SHELL_INLINE void stepThumb();
     void flushHalf();
     void flushWord();
 
@@ -80,11 +161,52 @@ class Arm : public Registers
     SHELL_INLINE void tickRam(u64 cycles);
     SHELL_INLINE void tickRom(u32 addr, u64 cycles);
     SHELL_INLINE void tickMultiply(u32 multiplier, bool sign);
+    template<Accuracy kAccuracy> SHELL_INLINE void tickRam(u64 cycles);
+    template<Accuracy kAccuracy> SHELL_INLINE void tickRom(u32 addr, u64 cycles);
+    template<Accuracy kAccuracy> SHELL_INLINE void tickMultiply(u32 multiplier, bool sign);
+
+    void mapPages();
+    void mapGpio();
 
     void interruptHw();
     void interruptSw();
     void interruptHandle(u64 late = 0);
 
+    bool isHle() const;
+    bool hleSwi(uint number);
+    void hleIrqEntry();
+    void hleIrqReturn();
+
+    bool swiDiv(s32 numerator, s32 denominator);
+    void swiSqrt();
+    u32  swiArcTan(s32 tan);
+    void swiArcTan2();
+    void swiCpuSet();
+    void swiCpuFastSet();
+    void swiBgAffineSet();
+    void swiObjAffineSet();
+    void swiLz77(bool vram);
+    void swiHuffman();
+    void swiRunLength(bool vram);
+
+    class Uncompressed
+    {
+    public:
+        Uncompressed(Arm& arm, u32 dst, bool vram);
+
+        u8 read(uint offset);
+        void write(u8 byte);
+
+        u32 size = 0;
+
+    private:
+        Arm& arm;
+        const u32 dst;
+        const bool vram;
+        u8 pending = 0;
+        Access access = Access::NonSequential;
+    };
+
     template<u32 kInstr> void Arm_BranchExchange(u32 instr);
     template<u32 kInstr> void Arm_BranchLink(u32 instr);
     template<u32 kInstr> void Arm_DataProcessing(u32 instr);
@@ -100,6 +222,7 @@ class Arm : public Registers
     template<u32 kInstr> void Arm_CoprocessorDataTransfers(u32 instr);
     template<u32 kInstr> void Arm_CoprocessorRegisterTransfers(u32 instr);
     template<u32 kInstr> void Arm_Undefined(u32 instr);
+    void Arm_Fused(u32 instr);
 
     template<u16 kInstr> void Thumb_MoveShiftedRegister(u16 instr);
     template<u16 kInstr> void Thumb_AddSubtract(u16 instr);
@@ -121,9 +244,23 @@ class Arm : public Registers
     template<u16 kInstr> void Thumb_UnconditionalBranch(u16 instr);
     template<u16 kInstr> void Thumb_LongBranchLink(u16 instr);
     template<u16 kInstr> void Thumb_Undefined(u16 instr);
+    void Thumb_Fused(u16 instr);
+    void Thumb_FusedCompareBranch(u16 instr);
+    void Thumb_FusedLongBranchLink(u16 instr);
 
-    Pipeline pipe;
-    u64 target = 0;
+    template<uint kSize>
+    struct alignas(4096) WorkRam : Ram<kSize> {};
+
+    Psr spsr;
+    u32 idle_loop = 0;
+
+    struct CodePage
+    {
+        u32 key = 0;
+        u8* data = nullptr;
+        bool rom = false;
+        shell::array<u8, 2> wait = {};
+    } code_page;
 
     struct Prefetch
     {
@@ -131,6 +268,22 @@ class Arm : public Registers
         u64 cycles = 0;
     } prefetch;
 
+    WaitControl waitcnt;
+
+    struct Banks
+    {
+        shell::array<u32, 6, 3> def = {};
+        shell::array<u32, 2, 5> fiq = {};
+    };
+
+    std::unique_ptr<Banks> banks = std::make_unique<Banks>();
+
+    Event slice;
+    BlockCacheArm blocks_arm;
+    BlockCacheThumb blocks_thumb;
+    Jit jit;
+    PageTable pages;
+
     struct Interrupt
     {
         bool isServable() const;
@@ -141,17 +294,17 @@ class Arm : public Registers
         InterruptMaster master;
     } interrupt;
 
-    WaitControl waitcnt;
     HaltControl haltcnt;
     PostFlag postflg;
 
     Bios bios;
-    Ram<256 * 1024> ewram = {};
-    Ram< 32 * 1024> iwram = {};
+    std::unique_ptr<WorkRam<256 * 1024>> ewram = std::make_unique<WorkRam<256 * 1024>>();
+    std::unique_ptr<WorkRam< 32 * 1024>> iwram = std::make_unique<WorkRam< 32 * 1024>>();
 };
 
 inline Arm arm;
 
 #include "arithmetic.inl"
+#include "memory.inl"
 #include "shifts.inl"
 #include "ticks.inl"
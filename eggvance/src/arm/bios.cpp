@@ -6,6 +6,8 @@
 
 void Bios::init(const fs::path& path)
 {
+    replaced = true;
+
     if (path.empty())
     {
         std::copy(replacement.begin(), replacement.end(), data.begin());
@@ -14,6 +16,10 @@ void Bios::init(const fs::path& path)
     {
         switch (fs::read(path, data))
         {
+        case fs::Status::Ok:
+            replaced = false;
+            break;
+
         case fs::Status::BadFile:
         case fs::Status::BadStream:
             video_ctx.showMessageBox("Warning", "Cannot read BIOS: {}\nThe replacement will be used", path);
@@ -43,6 +49,7 @@ Integral Bios::read(u32 addr)
     return latch >> (8 * (addr & 0x3));
 }
 
+bool Bios::replaced = true;
 Ram<Bios::kSize> Bios::data = {};
 Ram<Bios::kSize> Bios::replacement =
 {
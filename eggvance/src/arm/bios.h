@@ -6,7 +6,10 @@
 class Bios
 {
 public:
+    friend class Arm;
+
     static constexpr auto kSize = 16 * 1024;
+    static constexpr auto kIrqReturn = 0x30;
 
     static void init(const fs::path& path);
 
@@ -17,6 +20,7 @@ class Bios
 private:
     static Ram<kSize> data;
     static Ram<kSize> replacement;
+    static bool replaced;
 
     template<typename Integral>
     Integral read(u32 addr);
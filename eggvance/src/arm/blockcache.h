@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include <shell/array.h>
+#include <shell/macros.h>
+
+#include "base/int.h"
+
+template<typename Integral, typename Instruction>
+class Block
+{
+public:
+    static constexpr auto kMaxSize = 64;
+
+    struct Entry
+    {
+        Instruction handler = nullptr;
+        Integral instr = 0;
+    };
+
+    const Entry* begin() const
+    {
+        return entries.data();
+    }
+
+    const Entry* end() const
+    {
+        return entries.data() + size;
+    }
+
+    u32 addr  = 0;
+    u64 fetch = 0;
+    uint size = 0;
+    uint hits = 0;
+    uint epoch = 0;
+    bool idle  = false;
+    uint(*code)() = nullptr;
+    uint(*native)() = nullptr;
+    std::vector<Entry> entries;
+};
+
+template<typename Integral, typename Instruction>
+class BlockCache
+{
+public:
+    using Block = ::Block<Integral, Instruction>;
+    using Entry = typename Block::Entry;
+
+    SHELL_INLINE const Entry* next(u32 addr)
+    {
+        if (addr != cursor.addr || cursor.entry == cursor.end)
+        {
+            auto iter = blocks.find(addr);
+            if ( iter == blocks.end())
+                return nullptr;
+
+            seek(iter->second);
+        }
+
+        cursor.addr += sizeof(Integral);
+
+        return cursor.entry++;
+    }
+
+    SHELL_INLINE u64 fetch() const
+    {
+        return cursor.block->fetch;
+    }
+
+    SHELL_INLINE Block& block() const
+    {
+        return *cursor.block;
+    }
+
+    SHELL_INLINE void skip(uint count)
+    {
+        if (cursor.entry)
+        {
+            cursor.addr  += sizeof(Integral) * count;
+            cursor.entry += count;
+        }
+    }
+
+    const u64& invalidations() const
+    {
+        return invalidated;
+    }
+
+    const Entry* insert(Block&& block)
+    {
+        u32 addr = block.addr;
+
+        for (uint x = 0; x < block.entries.size(); ++x)
+            track(addr + sizeof(Integral) * x, addr);
+
+        seek(blocks[addr] = std::move(block));
+
+        cursor.addr += sizeof(Integral);
+
+        return cursor.entry++;
+    }
+
+    void clear()
+    {
+        cursor = Cursor();
+        blocks.clear();
+
+        for (auto& keys : pages)
+            keys.clear();
+
+        invalidated++;
+    }
+
+    SHELL_INLINE void write(u32 addr)
+    {
+        auto page = pageIndex(addr);
+        if ( page < kPages && !pages[page].empty())
+            invalidate(page);
+    }
+
+private:
+    static constexpr auto kPageBits = 8;
+    static constexpr auto kEwramPages = (256 * 1024) >> kPageBits;
+    static constexpr auto kIwramPages = ( 32 * 1024) >> kPageBits;
+    static constexpr auto kPages = kEwramPages + kIwramPages;
+
+    static uint pageIndex(u32 addr)
+    {
+        switch (addr >> 24)
+        {
+        case 0x2: return ((addr & 0x3'FFFF) >> kPageBits);
+        case 0x3: return ((addr & 0x0'7FFF) >> kPageBits) + kEwramPages;
+
+        default:
+            return kPages;
+        }
+    }
+
+    void seek(Block& block)
+    {
+        cursor.addr  = block.addr;
+        cursor.block = &block;
+        cursor.entry = block.begin();
+        cursor.end   = block.end();
+    }
+
+    void track(u32 addr, u32 key)
+    {
+        auto page = pageIndex(addr);
+        if ( page >= kPages)
+            return;
+
+        auto& keys = pages[page];
+        if (std::find(keys.begin(), keys.end(), key) == keys.end())
+            keys.push_back(key);
+    }
+
+    void invalidate(uint page)
+    {
+        for (u32 key : pages[page])
+        {
+            auto iter = blocks.find(key);
+            if ( iter == blocks.end())
+                continue;
+
+            if (cursor.block == &iter->second)
+                cursor = Cursor();
+
+            blocks.erase(iter);
+        }
+        pages[page].clear();
+        invalidated++;
+    }
+
+    struct Cursor
+    {
+        u32 addr = 0;
+        Block* block = nullptr;
+        const Entry* entry = nullptr;
+        const Entry* end   = nullptr;
+    } cursor;
+
+    u64 invalidated = 0;
+    std::unordered_map<u32, Block> blocks;
+    shell::array<std::vector<u32>, kPages> pages = {};
+};
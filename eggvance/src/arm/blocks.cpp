@@ -0,0 +1,426 @@
+#include "arm.h"
+
+#include <shell/operators.h>
+
+#include "decode.h"
+#include "recompiler.h"
+#include "gamepak/gamepak.h"
+
+enum class Usage
+{
+    N = 1 << 16,
+    Z = 1 << 17,
+    C = 1 << 18,
+    V = 1 << 19
+};
+
+static uint conditionFlags(uint condition)
+{
+    enum class Condition
+    {
+        EQ, NE, CS, CC,
+        MI, PL, VS, VC,
+        HI, LS, GE, LT,
+        GT, LE, AL, NV
+    };
+
+    switch (Condition(condition))
+    {
+    case Condition::EQ:
+    case Condition::NE: return uint(Usage::Z);
+    case Condition::CS:
+    case Condition::CC: return uint(Usage::C);
+    case Condition::MI:
+    case Condition::PL: return uint(Usage::N);
+    case Condition::VS:
+    case Condition::VC: return uint(Usage::V);
+    case Condition::HI:
+    case Condition::LS: return uint(Usage::C | Usage::Z);
+    case Condition::GE:
+    case Condition::LT: return uint(Usage::N | Usage::V);
+    case Condition::GT:
+    case Condition::LE: return uint(Usage::N | Usage::Z | Usage::V);
+
+    default:
+        return 0;
+    }
+}
+
+static bool usage(u16 instr, uint& reads, uint& writes)
+{
+    constexpr uint kLogical = uint(Usage::N | Usage::Z);
+    constexpr uint kArithmetic = uint(Usage::N | Usage::Z | Usage::C | Usage::V);
+
+    uint rd = bit::seq<0, 3>(instr);
+    uint rs = bit::seq<3, 3>(instr);
+    uint rn = bit::seq<6, 3>(instr);
+    uint load = bit::seq<11, 1>(instr);
+
+    switch (decodeThumb(hashThumb(instr)))
+    {
+    case InstructionThumb::MoveShiftedRegister:
+        reads  = 1 << rs;
+        writes = 1 << rd | kLogical;
+        if (bit::seq<6, 5>(instr) || bit::seq<11, 2>(instr))
+            writes |= uint(Usage::C);
+        return true;
+
+    case InstructionThumb::AddSubtract:
+        reads  = 1 << rs | (bit::seq<10, 1>(instr) ? 0 : 1 << rn);
+        writes = 1 << rd | kArithmetic;
+        return true;
+
+    case InstructionThumb::ImmediateOperations:
+    {
+        enum class Opcode { Mov, Cmp, Add, Sub };
+
+        uint opcode = bit::seq<11, 2>(instr);
+
+        rd = bit::seq<8, 3>(instr);
+        reads  = opcode == Opcode::Mov ? 0 : 1 << rd;
+        writes = opcode == Opcode::Cmp ? 0 : 1 << rd;
+        writes |= opcode == Opcode::Mov ? kLogical : kArithmetic;
+        return true;
+    }
+
+    case InstructionThumb::AluOperations:
+    {
+        enum class Opcode
+        {
+            And, Eor, Lsl, Lsr,
+            Asr, Adc, Sbc, Ror,
+            Tst, Neg, Cmp, Cmn,
+            Orr, Mul, Bic, Mvn
+        };
+
+        uint opcode = bit::seq<6, 4>(instr);
+
+        reads  = 1 << rd | 1 << rs;
+        writes = 1 << rd | kArithmetic;
+
+        switch (Opcode(opcode))
+        {
+        case Opcode::Adc:
+        case Opcode::Sbc:
+            reads |= uint(Usage::C);
+            break;
+
+        case Opcode::Tst:
+        case Opcode::Cmp:
+        case Opcode::Cmn:
+            writes &= ~(1 << rd);
+            break;
+
+        case Opcode::Neg:
+        case Opcode::Mvn:
+            if (rd != rs)
+                reads &= ~(1 << rd);
+            break;
+        }
+        return true;
+    }
+
+    case InstructionThumb::HighRegisterOperations:
+    {
+        enum class Opcode { Add, Cmp, Mov, Bx };
+
+        uint opcode = bit::seq<8, 2>(instr);
+
+        rd |= bit::seq<7, 1>(instr) << 3;
+        rs |= bit::seq<6, 1>(instr) << 3;
+
+        if (opcode == Opcode::Bx || rd == 15)
+            return false;
+
+        reads  = (opcode == Opcode::Mov ? 0 : 1 << rd) | 1 << rs;
+        writes = opcode == Opcode::Cmp ? kArithmetic : 1 << rd;
+        return true;
+    }
+
+    case InstructionThumb::LoadPcRelative:
+        reads  = 0;
+        writes = 1 << bit::seq<8, 3>(instr);
+        return true;
+
+    case InstructionThumb::LoadStoreRegisterOffset:
+        reads  = 1 << rs | 1 << rn;
+        writes = 1 << rd;
+        return load;
+
+    case InstructionThumb::LoadStoreByteHalf:
+        reads  = 1 << rs | 1 << rn;
+        writes = 1 << rd;
+        return bit::seq<10, 2>(instr) != 0;
+
+    case InstructionThumb::LoadStoreImmediateOffset:
+    case InstructionThumb::LoadStoreHalf:
+        reads  = 1 << rs;
+        writes = 1 << rd;
+        return load;
+
+    case InstructionThumb::LoadStoreSpRelative:
+        reads  = 1 << 13;
+        writes = 1 << bit::seq<8, 3>(instr);
+        return load;
+
+    case InstructionThumb::LoadRelativeAddress:
+        reads  = load ? 1 << 13 : 0;
+        writes = 1 << bit::seq<8, 3>(instr);
+        return true;
+
+    case InstructionThumb::AddOffsetSp:
+        reads  = 1 << 13;
+        writes = 1 << 13;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+static bool usage(u32 instr, uint& reads, uint& writes)
+{
+    constexpr uint kLogical = uint(Usage::N | Usage::Z | Usage::C);
+    constexpr uint kArithmetic = uint(Usage::N | Usage::Z | Usage::C | Usage::V);
+
+    uint rd = bit::seq<12, 4>(instr);
+    uint rn = bit::seq<16, 4>(instr);
+    uint rm = bit::seq< 0, 4>(instr);
+    uint rs = bit::seq< 8, 4>(instr);
+
+    if (bit::seq<28, 4>(instr) != 0xE || rd == 15)
+        return false;
+
+    switch (decodeArm(hashArm(instr)))
+    {
+    case InstructionArm::DataProcessing:
+    {
+        enum class Opcode
+        {
+            And, Eor, Sub, Rsb,
+            Add, Adc, Sbc, Rsc,
+            Tst, Teq, Cmp, Cmn,
+            Orr, Mov, Bic, Mvn
+        };
+
+        uint opcode = bit::seq<21, 4>(instr);
+        uint flags  = bit::seq<20, 1>(instr);
+
+        bool logical = opcode <= Opcode::Eor || (opcode >= Opcode::Tst && opcode <= Opcode::Teq) || opcode >= Opcode::Orr;
+        bool compare = opcode >= Opcode::Tst && opcode <= Opcode::Cmn;
+
+        reads  = (opcode == Opcode::Mov || opcode == Opcode::Mvn) ? 0 : 1 << rn;
+        writes = compare ? 0 : 1 << rd;
+
+        if (!bit::seq<25, 1>(instr))
+        {
+            reads |= 1 << rm;
+            if (bit::seq<4, 1>(instr))
+                reads |= 1 << rs;
+        }
+
+        if (opcode == Opcode::Adc || opcode == Opcode::Sbc || opcode == Opcode::Rsc)
+            reads |= uint(Usage::C);
+
+        if (flags)
+            writes |= logical ? kLogical : kArithmetic;
+
+        return true;
+    }
+
+    case InstructionArm::Multiply:
+        reads  = 1 << rm | 1 << rs | (bit::seq<21, 1>(instr) ? 1 << rd : 0);
+        writes = 1 << rn | (bit::seq<20, 1>(instr) ? kLogical : 0);
+        return rn != 15;
+
+    case InstructionArm::SingleDataTransfer:
+        reads  = 1 << rn | (bit::seq<25, 1>(instr) ? 1 << rm : 0);
+        writes = 1 << rd;
+        return bit::seq<20, 1>(instr) && bit::seq<24, 1>(instr) && !bit::seq<21, 1>(instr);
+
+    case InstructionArm::HalfSignedDataTransfer:
+        reads  = 1 << rn | (bit::seq<22, 1>(instr) ? 0 : 1 << rm);
+        writes = 1 << rd;
+        return bit::seq<20, 1>(instr) && bit::seq<24, 1>(instr) && !bit::seq<21, 1>(instr);
+
+    default:
+        return false;
+    }
+}
+
+static bool branchesTo(u16 instr, u32 addr, u32 target, uint& reads)
+{
+    switch (decodeThumb(hashThumb(instr)))
+    {
+    case InstructionThumb::ConditionalBranch:
+        reads = conditionFlags(bit::seq<8, 4>(instr));
+        return addr + 4 + (bit::signEx<8>(static_cast<u32>(bit::seq<0, 8>(instr))) << 1) == target;
+
+    case InstructionThumb::UnconditionalBranch:
+        reads = 0;
+        return addr + 4 + (bit::signEx<11>(static_cast<u32>(bit::seq<0, 11>(instr))) << 1) == target;
+
+    default:
+        return false;
+    }
+}
+
+static bool branchesTo(u32 instr, u32 addr, u32 target, uint& reads)
+{
+    if (decodeArm(hashArm(instr)) != InstructionArm::BranchLink || bit::seq<24, 1>(instr))
+        return false;
+
+    reads = conditionFlags(bit::seq<28, 4>(instr));
+    return addr + 8 + (bit::signEx<24>(bit::seq<0, 24>(instr)) << 2) == target;
+}
+
+template<typename Block>
+static bool isIdleLoop(const Block& block)
+{
+    constexpr uint kSize = sizeof(block.entries[0].instr);
+
+    uint carried = 0;
+    uint written = 0;
+
+    for (uint x = 0; x < block.size; ++x)
+    {
+        uint reads  = 0;
+        uint writes = 0;
+
+        if (x + 1 == block.size)
+        {
+            if (!branchesTo(block.entries[x].instr, block.addr + kSize * x, block.addr, reads))
+                return false;
+        }
+        else if (!usage(block.entries[x].instr, reads, writes))
+        {
+            return false;
+        }
+
+        carried |= reads & ~written & ~(1 << 15);
+        written |= writes;
+    }
+    return (carried & written) == 0;
+}
+
+template<typename Integral>
+bool Arm::readCode(u32 addr, Integral& instr) const
+{
+    switch (Region(addr >> 24))
+    {
+    case Region::ExternalWorkRam:
+        if constexpr (sizeof(Integral) == 2)
+            instr = ewram->readHalf(addr);
+        else
+            instr = ewram->readWord(addr);
+        return true;
+
+    case Region::InternalWorkRam:
+        if constexpr (sizeof(Integral) == 2)
+            instr = iwram->readHalf(addr);
+        else
+            instr = iwram->readWord(addr);
+        return true;
+
+    case Region::GamePak2H:
+        if (gamepak.isEepromAccess(addr))
+            return false;
+        [[fallthrough]];
+
+    case Region::GamePak0L:
+    case Region::GamePak0H:
+    case Region::GamePak1L:
+    case Region::GamePak1H:
+    case Region::GamePak2L:
+        if (gamepak.gpio->isAccess(addr & (gamepak.rom.mask - sizeof(Integral))))
+            return false;
+
+        instr = gamepak.read<Integral>(addr);
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+template<typename Integral, typename Instruction, std::size_t kSize>
+const typename BlockCache<Integral, Instruction>::Entry* Arm::compile(BlockCache<Integral, Instruction>& cache, const std::array<Instruction, kSize>& table, u32 addr)
+{
+    using Block = typename BlockCache<Integral, Instruction>::Block;
+
+    Block block;
+    block.addr = addr;
+
+    switch (Region(addr >> 24))
+    {
+    case Region::ExternalWorkRam:
+        block.fetch = sizeof(Integral) == 2 ? 3 : 6;
+        break;
+
+    case Region::InternalWorkRam:
+        block.fetch = 1;
+        break;
+    }
+
+    for (u32 next = addr; block.size < Block::kMaxSize; next += sizeof(Integral))
+    {
+        if ((next + 2 * sizeof(Integral)) >> 24 != addr >> 24)
+            break;
+
+        Integral instr;
+        if (!readCode(next, instr))
+            break;
+
+        if constexpr (sizeof(Integral) == 2)
+            block.entries.push_back({ table[hashThumb(instr)], instr });
+        else
+            block.entries.push_back({ table[hashArm(instr)], instr });
+
+        block.size++;
+
+        if (isTerminal(instr))
+            break;
+    }
+
+    if (block.size == 0)
+        return nullptr;
+
+    block.idle = isIdleLoop(block);
+    block.native = recompiler.find(addr, sizeof(Integral) == 2, block.size);
+
+    if (!(state & State::Profile))
+    {
+        for (uint x = 0; x + 1 < block.size; ++x)
+        {
+            if (auto handler = fuse(block.entries[x].instr, block.entries[x + 1].instr))
+                block.entries[x].handler = handler;
+        }
+    }
+
+    for (uint x = 0; x < 2; ++x)
+    {
+        Integral instr = 0;
+        if (!readCode(addr + sizeof(Integral) * (block.size + x), instr))
+            return nullptr;
+
+        block.entries.push_back({ nullptr, instr });
+    }
+
+    return cache.insert(std::move(block));
+}
+
+const Arm::BlockCacheThumb::Entry* Arm::compileThumb(u32 addr)
+{
+    return compile(blocks_thumb, instr_thumb, addr);
+}
+
+const Arm::BlockCacheArm::Entry* Arm::compileArm(u32 addr)
+{
+    return compile(blocks_arm, instr_arm, addr);
+}
+
+void Arm::invalidate(u32 addr)
+{
+    blocks_thumb.write(addr);
+    blocks_arm.write(addr);
+}
@@ -12,6 +12,26 @@ enum class Irq
     GamePak = 1 << 13
 };
 
+enum class Region
+{
+    Bios,
+    Unused,
+    ExternalWorkRam,
+    InternalWorkRam,
+    Io,
+    PaletteRam,
+    VideoRam,
+    Oam,
+    GamePak0L,
+    GamePak0H,
+    GamePak1L,
+    GamePak1H,
+    GamePak2L,
+    GamePak2H,
+    SaveL,
+    SaveH
+};
+
 enum class Access
 {
     NonSequential,
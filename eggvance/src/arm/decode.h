@@ -171,3 +171,57 @@ constexpr InstructionThumb decodeThumb(uint hash)
 
     return InstructionThumb::Undefined;
 }
+
+constexpr bool isTerminal(u16 instr)
+{
+    switch (decodeThumb(hashThumb(instr)))
+    {
+    case InstructionThumb::HighRegisterOperations:
+        return bit::seq<8, 2>(instr) == 3 || (bit::seq<7, 1>(instr) && bit::seq<0, 3>(instr) == 7);
+
+    case InstructionThumb::PushPopRegisters:
+        return bit::seq<11, 1>(instr) && bit::seq<8, 1>(instr);
+
+    case InstructionThumb::LoadStoreMultiple:
+        return bit::seq<0, 8>(instr) == 0;
+
+    case InstructionThumb::LongBranchLink:
+        return bit::seq<11, 1>(instr);
+
+    case InstructionThumb::ConditionalBranch:
+    case InstructionThumb::SoftwareInterrupt:
+    case InstructionThumb::UnconditionalBranch:
+    case InstructionThumb::Undefined:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+constexpr bool isTerminal(u32 instr)
+{
+    uint rd = bit::seq<12, 4>(instr);
+
+    switch (decodeArm(hashArm(instr)))
+    {
+    case InstructionArm::DataProcessing:
+        return rd == 15;
+
+    case InstructionArm::SingleDataTransfer:
+    case InstructionArm::HalfSignedDataTransfer:
+        return rd == 15 && bit::seq<20, 1>(instr);
+
+    case InstructionArm::BlockDataTransfer:
+        return bit::seq<20, 1>(instr) && (bit::seq<15, 1>(instr) || bit::seq<0, 16>(instr) == 0);
+
+    case InstructionArm::StatusTransfer:
+    case InstructionArm::Multiply:
+    case InstructionArm::MultiplyLong:
+    case InstructionArm::SingleDataSwap:
+        return false;
+
+    default:
+        return true;
+    }
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <cstring>
+
+#include "base/int.h"
+
+enum class Reg
+{
+    Rax, Rcx, Rdx, Rbx, Rsp, Rbp, Rsi, Rdi,
+    R8 , R9 , R10, R11, R12, R13, R14, R15
+};
+
+enum class Cond
+{
+    O , No, B , Ae, E , Ne, Be, A ,
+    S , Ns, P , Np, L , Ge, Le, G
+};
+
+enum class Alu
+{
+    Add, Or, Adc, Sbb, And, Sub, Xor, Cmp
+};
+
+enum class Sft
+{
+    Ror = 1, Shl = 4, Shr = 5, Sar = 7
+};
+
+struct Mem
+{
+    Reg base;
+    s32 disp;
+};
+
+class Emitter
+{
+public:
+    Emitter(u8* data, std::size_t capacity)
+        : data(data), capacity(capacity) {}
+
+    u8* begin() const
+    {
+        return data;
+    }
+
+    std::size_t size() const
+    {
+        return used;
+    }
+
+    bool isFull() const
+    {
+        return used > capacity;
+    }
+
+    void push(Reg reg)
+    {
+        rex(false, 0, uint(reg));
+        byte(0x50 + (uint(reg) & 0x7));
+    }
+
+    void pop(Reg reg)
+    {
+        rex(false, 0, uint(reg));
+        byte(0x58 + (uint(reg) & 0x7));
+    }
+
+    void ret()
+    {
+        byte(0xC3);
+    }
+
+    void mov(Reg dst, u32 imm)
+    {
+        rex(false, 0, uint(dst));
+        byte(0xB8 + (uint(dst) & 0x7));
+        dword(imm);
+    }
+
+    void mov64(Reg dst, u64 imm)
+    {
+        rex(true, 0, uint(dst));
+        byte(0xB8 + (uint(dst) & 0x7));
+        qword(imm);
+    }
+
+    void mov(Reg dst, Reg src)      { encode(0x89, uint(src), dst); }
+    void mov(Reg dst, Mem src)      { encode(0x8B, uint(dst), src); }
+    void mov(Mem dst, Reg src)      { encode(0x89, uint(src), dst); }
+    void mov64(Reg dst, Mem src)    { encode(0x8B, uint(dst), src, true); }
+    void cmp64(Reg dst, Mem src)    { encode(0x3B, uint(dst), src, true); }
+
+    void mov(Mem dst, u32 imm)
+    {
+        encode(0xC7, 0, dst);
+        dword(imm);
+    }
+
+    void alu(Alu op, Reg dst, Reg src)
+    {
+        encode(0x01 + 8 * uint(op), uint(src), dst);
+    }
+
+    void alu(Alu op, Reg dst, Mem src)
+    {
+        encode(0x03 + 8 * uint(op), uint(dst), src);
+    }
+
+    void alu(Alu op, Reg dst, u32 imm)
+    {
+        encode(0x81, uint(op), dst);
+        dword(imm);
+    }
+
+    void alu(Alu op, Mem dst, u8 imm)
+    {
+        encode(0x83, uint(op), dst);
+        byte(imm);
+    }
+
+    void alu64(Alu op, Reg dst, Mem src)
+    {
+        encode(0x03 + 8 * uint(op), uint(dst), src, true);
+    }
+
+    void alu64(Alu op, Reg dst, u8 imm)
+    {
+        encode(0x83, uint(op), dst, true);
+        byte(imm);
+    }
+
+    void shift(Sft op, Reg dst, u8 amount)
+    {
+        encode(0xC1, uint(op), dst);
+        byte(amount);
+    }
+
+    void bitNot(Reg dst)
+    {
+        encode(0xF7, 2, dst);
+    }
+
+    void test(Reg dst, Reg src)
+    {
+        encode(0x85, uint(src), dst);
+    }
+
+    void set(Cond cond, Mem dst)
+    {
+        encode(0x0F90 + uint(cond), 0, dst);
+    }
+
+    void call(const void* function)
+    {
+        mov64(Reg::Rax, reinterpret_cast<u64>(function));
+        encode(0xFF, 2, Reg::Rax);
+    }
+
+    std::size_t jump(Cond cond)
+    {
+        word(0x800F + (uint(cond) << 8));
+        dword(0);
+        return used;
+    }
+
+    void bind(std::size_t label)
+    {
+        if (label <= capacity)
+        {
+            s32 rel = static_cast<s32>(used - label);
+            std::memcpy(data + label - 4, &rel, sizeof(rel));
+        }
+    }
+
+private:
+    void byte(u8 value)
+    {
+        if (used < capacity)
+            data[used] = value;
+        used++;
+    }
+
+    void word(u16 value)
+    {
+        byte(value >> 0);
+        byte(value >> 8);
+    }
+
+    void dword(u32 value)
+    {
+        word(value >>  0);
+        word(value >> 16);
+    }
+
+    void qword(u64 value)
+    {
+        dword(static_cast<u32>(value >>  0));
+        dword(static_cast<u32>(value >> 32));
+    }
+
+    void rex(bool wide, uint reg, uint rm)
+    {
+        u8 prefix = 0x40 | (wide << 3) | ((reg >> 3) << 2) | (rm >> 3);
+        if (prefix != 0x40)
+            byte(prefix);
+    }
+
+    void opcode(uint value)
+    {
+        if (value > 0xFF)
+            byte(value >> 8);
+        byte(value);
+    }
+
+    void encode(uint op, uint reg, Reg rm, bool wide = false)
+    {
+        rex(wide, reg, uint(rm));
+        opcode(op);
+        byte(0xC0 | ((reg & 0x7) << 3) | (uint(rm) & 0x7));
+    }
+
+    void encode(uint op, uint reg, Mem mem, bool wide = false)
+    {
+        rex(wide, reg, uint(mem.base));
+        opcode(op);
+        byte(0x80 | ((reg & 0x7) << 3) | (uint(mem.base) & 0x7));
+        if ((uint(mem.base) & 0x7) == uint(Reg::Rsp))
+            byte(0x24);
+        dword(mem.disp);
+    }
+
+    u8* data;
+    std::size_t capacity;
+    std::size_t used = 0;
+};
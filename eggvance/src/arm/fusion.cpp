@@ -0,0 +1,238 @@
+#include "arm.h"
+
+#include "decode.h"
+
+static bool isCompare(u16 instr)
+{
+    switch (decodeThumb(hashThumb(instr)))
+    {
+    case InstructionThumb::ImmediateOperations:
+        return bit::seq<11, 2>(instr) == 1;
+
+    case InstructionThumb::AluOperations:
+        return bit::seq<6, 4>(instr) == 8 || bit::seq<6, 4>(instr) == 10 || bit::seq<6, 4>(instr) == 11;
+
+    case InstructionThumb::HighRegisterOperations:
+        return bit::seq<8, 2>(instr) == 1;
+
+    default:
+        return false;
+    }
+}
+
+static bool isCompare(u32 instr)
+{
+    if (decodeArm(hashArm(instr)) != InstructionArm::DataProcessing || !bit::seq<20, 1>(instr))
+        return false;
+
+    uint opcode = bit::seq<21, 4>(instr);
+
+    return opcode >= 8 && opcode <= 11;
+}
+
+static bool isLoad(u16 instr)
+{
+    switch (decodeThumb(hashThumb(instr)))
+    {
+    case InstructionThumb::LoadPcRelative:
+        return true;
+
+    case InstructionThumb::LoadStoreRegisterOffset:
+    case InstructionThumb::LoadStoreImmediateOffset:
+        return bit::seq<11, 1>(instr);
+
+    default:
+        return false;
+    }
+}
+
+static bool isAdd(u16 instr)
+{
+    switch (decodeThumb(hashThumb(instr)))
+    {
+    case InstructionThumb::AddSubtract:
+        return true;
+
+    case InstructionThumb::ImmediateOperations:
+        return bit::seq<11, 2>(instr) >= 2;
+
+    default:
+        return false;
+    }
+}
+
+static bool isMove(u16 instr)
+{
+    return decodeThumb(hashThumb(instr)) == InstructionThumb::ImmediateOperations && bit::seq<11, 2>(instr) == 0;
+}
+
+static bool isShift(u16 instr)
+{
+    return decodeThumb(hashThumb(instr)) == InstructionThumb::MoveShiftedRegister;
+}
+
+static bool isBranch(u16 instr)
+{
+    return decodeThumb(hashThumb(instr)) == InstructionThumb::ConditionalBranch;
+}
+
+static bool isBranch(u32 instr)
+{
+    return decodeArm(hashArm(instr)) == InstructionArm::BranchLink && !bit::seq<24, 1>(instr);
+}
+
+static bool isLongBranchLink(u16 instr, uint second)
+{
+    return decodeThumb(hashThumb(instr)) == InstructionThumb::LongBranchLink && bit::seq<11, 1>(instr) == second;
+}
+
+Arm::Instruction16 Arm::fuse(u16 instr, u16 next) const
+{
+    if (isLongBranchLink(instr, 0) && isLongBranchLink(next, 1))
+        return &Thumb_Handler<&Arm::Thumb_FusedLongBranchLink>;
+
+    if (isCompare(instr) && isBranch(next))
+        return &Thumb_Handler<&Arm::Thumb_FusedCompareBranch>;
+
+    if ((isLoad(instr) && isAdd(next)) || (isMove(instr) && isShift(next)))
+        return &Thumb_Handler<&Arm::Thumb_Fused>;
+
+    return nullptr;
+}
+
+Arm::Instruction32 Arm::fuse(u32 instr, u32 next) const
+{
+    if (isCompare(instr) && isBranch(next))
+        return &Arm_Handler<&Arm::Arm_Fused>;
+
+    return nullptr;
+}
+
+SHELL_INLINE void Arm::advanceThumb()
+{
+    pc += 2;
+    pipe[0] = pipe[1];
+
+    if (auto entry = blocks_thumb.next(pc - 4))
+    {
+        pipe[1] = entry[2].instr;
+
+        if (u64 fetch = blocks_thumb.fetch())
+            tickRam(fetch);
+        else
+            tickRom(pc, waitcnt.waitHalf(pc, pipe.access));
+    }
+    else
+    {
+        pipe[1] = fetch<u16>(pc, pipe.access);
+    }
+    pipe.access = Access::Sequential;
+    instructions++;
+}
+
+SHELL_INLINE void Arm::advanceArm()
+{
+    pc += 4;
+    pipe[0] = pipe[1];
+
+    if (auto entry = blocks_arm.next(pc - 8))
+    {
+        pipe[1] = entry[2].instr;
+
+        if (u64 fetch = blocks_arm.fetch())
+            tickRam(fetch);
+        else
+            tickRom(pc, waitcnt.waitWord(pc, pipe.access));
+    }
+    else
+    {
+        pipe[1] = fetch<u32>(pc, pipe.access);
+    }
+    pipe.access = Access::Sequential;
+    instructions++;
+}
+
+void Arm::Thumb_Fused(u16 instr)
+{
+    uint previous = state;
+
+    instr_thumb[hashThumb(instr)](*this, instr);
+
+    if (state != previous)
+        return;
+
+    u16 next = pipe[0];
+
+    advanceThumb();
+
+    instr_thumb[hashThumb(next)](*this, next);
+}
+
+void Arm::Thumb_FusedCompareBranch(u16 instr)
+{
+    uint previous = state;
+
+    instr_thumb[hashThumb(instr)](*this, instr);
+
+    if (state != previous)
+        return;
+
+    u16 next = pipe[0];
+    if (!isBranch(next))
+        return;
+
+    advanceThumb();
+
+    if (cpsr.check(bit::seq<8, 4>(next)))
+    {
+        uint offset = bit::seq<0, 8>(next);
+
+        offset = bit::signEx<8>(offset);
+        offset <<= 1;
+
+        pc += offset;
+        flushHalf();
+    }
+}
+
+void Arm::Thumb_FusedLongBranchLink(u16 instr)
+{
+    u16 next = pipe[0];
+    if (!isLongBranchLink(next, 1))
+    {
+        instr_thumb[hashThumb(instr)](*this, instr);
+        return;
+    }
+
+    u32 offset = bit::seq<0, 11>(instr);
+
+    offset = bit::signEx<11>(offset);
+    offset <<= 12;
+
+    advanceThumb();
+
+    u32 link = (pc - 2) | 0x1;
+    pc = pc - 2 + offset + (bit::seq<0, 11>(next) << 1);
+    lr = link;
+
+    flushHalf();
+}
+
+void Arm::Arm_Fused(u32 instr)
+{
+    uint previous = state;
+
+    instr_arm[hashArm(instr)](*this, instr);
+
+    if (state != previous)
+        return;
+
+    u32 next = pipe[0];
+
+    advanceArm();
+
+    if (cpsr.check(next >> 28))
+    {
+        instr_arm[hashArm(next)](*this, next);
+    }
+}
@@ -0,0 +1,552 @@
+#include "arm.h"
+
+#include <limits>
+
+#include "base/config.h"
+
+enum class Swi
+{
+    Div            = 0x06,
+    DivArm         = 0x07,
+    Sqrt           = 0x08,
+    ArcTan         = 0x09,
+    ArcTan2        = 0x0A,
+    CpuSet         = 0x0B,
+    CpuFastSet     = 0x0C,
+    BgAffineSet    = 0x0E,
+    ObjAffineSet   = 0x0F,
+    LZ77UnCompWram = 0x11,
+    LZ77UnCompVram = 0x12,
+    HuffUnComp     = 0x13,
+    RLUnCompWram   = 0x14,
+    RLUnCompVram   = 0x15
+};
+
+static constexpr u32 kLatchIrq  = 0xE55E'C002;
+static constexpr u32 kLatchSwi  = 0xE3A0'2004;
+static constexpr u64 kSwiCycles = 24;
+static constexpr u64 kIrqCycles = 12;
+
+static constexpr s16 kSine[256] =
+{
+         0,    402,    803,   1205,   1605,   2005,   2404,   2801,   3196,   3589,   3980,   4369,   4756,   5139,   5519,   5896,
+      6269,   6639,   7005,   7366,   7723,   8075,   8423,   8765,   9102,   9434,   9759,  10079,  10393,  10701,  11002,  11297,
+     11585,  11866,  12139,  12406,  12665,  12916,  13159,  13395,  13622,  13842,  14053,  14255,  14449,  14634,  14810,  14978,
+     15136,  15286,  15426,  15557,  15678,  15790,  15892,  15985,  16069,  16142,  16206,  16260,  16305,  16339,  16364,  16379,
+     16384,  16379,  16364,  16339,  16305,  16260,  16206,  16142,  16069,  15985,  15892,  15790,  15678,  15557,  15426,  15286,
+     15136,  14978,  14810,  14634,  14449,  14255,  14053,  13842,  13622,  13395,  13159,  12916,  12665,  12406,  12139,  11866,
+     11585,  11297,  11002,  10701,  10393,  10079,   9759,   9434,   9102,   8765,   8423,   8075,   7723,   7366,   7005,   6639,
+      6269,   5896,   5519,   5139,   4756,   4369,   3980,   3589,   3196,   2801,   2404,   2005,   1605,   1205,    803,    402,
+         0,   -402,   -803,  -1205,  -1605,  -2005,  -2404,  -2801,  -3196,  -3589,  -3980,  -4369,  -4756,  -5139,  -5519,  -5896,
+     -6269,  -6639,  -7005,  -7366,  -7723,  -8075,  -8423,  -8765,  -9102,  -9434,  -9759, -10079, -10393, -10701, -11002, -11297,
+    -11585, -11866, -12139, -12406, -12665, -12916, -13159, -13395, -13622, -13842, -14053, -14255, -14449, -14634, -14810, -14978,
+    -15136, -15286, -15426, -15557, -15678, -15790, -15892, -15985, -16069, -16142, -16206, -16260, -16305, -16339, -16364, -16379,
+    -16384, -16379, -16364, -16339, -16305, -16260, -16206, -16142, -16069, -15985, -15892, -15790, -15678, -15557, -15426, -15286,
+    -15136, -14978, -14810, -14634, -14449, -14255, -14053, -13842, -13622, -13395, -13159, -12916, -12665, -12406, -12139, -11866,
+    -11585, -11297, -11002, -10701, -10393, -10079,  -9759,  -9434,  -9102,  -8765,  -8423,  -8075,  -7723,  -7366,  -7005,  -6639,
+     -6269,  -5896,  -5519,  -5139,  -4756,  -4369,  -3980,  -3589,  -3196,  -2801,  -2404,  -2005,  -1605,  -1205,   -803,   -402
+};
+
+static uint bitWidth(u32 value)
+{
+    uint width = 0;
+    for (; value; value >>= 1)
+        width++;
+
+    return width;
+}
+
+bool Arm::isHle() const
+{
+    return config.bios_hle && Bios::replaced;
+}
+
+bool Arm::hleSwi(uint number)
+{
+    switch (Swi(number))
+    {
+    case Swi::Div:
+        if (!swiDiv(gprs[0], gprs[1]))
+            return false;
+        break;
+
+    case Swi::DivArm:
+        if (!swiDiv(gprs[1], gprs[0]))
+            return false;
+        break;
+
+    case Swi::Sqrt:           swiSqrt(); break;
+    case Swi::ArcTan:         gprs[0] = swiArcTan(gprs[0]); break;
+    case Swi::ArcTan2:        swiArcTan2(); break;
+    case Swi::CpuSet:         swiCpuSet(); break;
+    case Swi::CpuFastSet:     swiCpuFastSet(); break;
+    case Swi::BgAffineSet:    swiBgAffineSet(); break;
+    case Swi::ObjAffineSet:   swiObjAffineSet(); break;
+    case Swi::LZ77UnCompWram: swiLz77(false); break;
+    case Swi::LZ77UnCompVram: swiLz77(true); break;
+    case Swi::HuffUnComp:     swiHuffman(); break;
+    case Swi::RLUnCompWram:   swiRunLength(false); break;
+    case Swi::RLUnCompVram:   swiRunLength(true); break;
+
+    default:
+        return false;
+    }
+
+    idle(kSwiCycles);
+    bios.latch = kLatchSwi;
+
+    return true;
+}
+
+void Arm::hleIrqEntry()
+{
+    sp -= 24;
+    writeWord(sp +  0, gprs[ 0], Access::NonSequential);
+    writeWord(sp +  4, gprs[ 1], Access::Sequential);
+    writeWord(sp +  8, gprs[ 2], Access::Sequential);
+    writeWord(sp + 12, gprs[ 3], Access::Sequential);
+    writeWord(sp + 16, gprs[12], Access::Sequential);
+    writeWord(sp + 20, lr, Access::Sequential);
+
+    idle(kIrqCycles);
+
+    gprs[0] = 0x0400'0000;
+    lr = Bios::kIrqReturn;
+    pc = readWord(0x0300'7FFC) & ~0x3;
+}
+
+void Arm::hleIrqReturn()
+{
+    gprs[ 0] = readWord(sp +  0, Access::NonSequential);
+    gprs[ 1] = readWord(sp +  4, Access::Sequential);
+    gprs[ 2] = readWord(sp +  8, Access::Sequential);
+    gprs[ 3] = readWord(sp + 12, Access::Sequential);
+    gprs[12] = readWord(sp + 16, Access::Sequential);
+    lr       = readWord(sp + 20, Access::Sequential);
+    sp += 24;
+
+    idle(kIrqCycles);
+
+    Psr spsr = this->spsr;
+    switchMode(spsr.m);
+    cpsr = spsr;
+
+    pc = lr - 4;
+    if (cpsr.t)
+    {
+        flushHalf();
+        state |= State::Thumb;
+    }
+    else
+    {
+        flushWord();
+    }
+    bios.latch = kLatchIrq;
+}
+
+bool Arm::swiDiv(s32 numerator, s32 denominator)
+{
+    if (denominator == 0)
+        return false;
+
+    s32 quotient  = numerator;
+    s32 remainder = 0;
+
+    if (numerator != std::numeric_limits<s32>::min() || denominator != -1)
+    {
+        quotient  = numerator / denominator;
+        remainder = numerator % denominator;
+    }
+
+    gprs[0] = quotient;
+    gprs[1] = remainder;
+    gprs[3] = quotient < 0 ? -u32(quotient) : u32(quotient);
+
+    uint num = bitWidth(numerator   < 0 ? -u32(numerator)   : u32(numerator));
+    uint den = bitWidth(denominator < 0 ? -u32(denominator) : u32(denominator));
+
+    idle(11 + 13 * (num > den ? num - den : 0));
+
+    return true;
+}
+
+void Arm::swiSqrt()
+{
+    u32 value = gprs[0];
+    u32 root  = 0;
+
+    for (u32 bit = 1 << 30; bit; bit >>= 2)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+    }
+    gprs[0] = root;
+
+    idle(4 + 16 * bitWidth(root));
+}
+
+u32 Arm::swiArcTan(s32 tan)
+{
+    auto mul = [](s32 a, s32 b) -> s32
+    {
+        return static_cast<u32>(a) * static_cast<u32>(b);
+    };
+
+    s32 a = -(mul(tan, tan) >> 14);
+    s32 b = (mul(0xA9, a) >> 14) + 0x390;
+    b = (mul(b, a) >> 14) + 0x91C;
+    b = (mul(b, a) >> 14) + 0xFB6;
+    b = (mul(b, a) >> 14) + 0x16AA;
+    b = (mul(b, a) >> 14) + 0x2081;
+    b = (mul(b, a) >> 14) + 0x3651;
+    b = (mul(b, a) >> 14) + 0xA2F9;
+
+    gprs[1] = a;
+    gprs[3] = b;
+
+    idle(37);
+
+    return mul(tan, b) >> 16;
+}
+
+void Arm::swiArcTan2()
+{
+    s32 x = static_cast<s16>(gprs[0]);
+    s32 y = static_cast<s16>(gprs[1]);
+
+    u32 angle;
+    if (y == 0)
+    {
+        angle = x >= 0 ? 0x0000 : 0x8000;
+    }
+    else if (x == 0)
+    {
+        angle = y >= 0 ? 0x4000 : 0xC000;
+    }
+    else if (y >= 0)
+    {
+        if (x >= 0 && x >= y)
+            angle = swiArcTan((y << 14) / x);
+        else if (x < 0 && -x >= y)
+            angle = swiArcTan((y << 14) / x) + 0x8000;
+        else
+            angle = 0x4000 - swiArcTan((x << 14) / y);
+    }
+    else
+    {
+        if (x <= 0 && -x > -y)
+            angle = swiArcTan((y << 14) / x) + 0x8000;
+        else if (x > 0 && x >= -y)
+            angle = swiArcTan((y << 14) / x) + 0x10000;
+        else
+            angle = 0xC000 - swiArcTan((x << 14) / y);
+    }
+    gprs[0] = angle & 0xFFFF;
+    gprs[3] = 0x170;
+}
+
+void Arm::swiCpuSet()
+{
+    u32 src = gprs[0];
+    u32 dst = gprs[1];
+    u32 control = gprs[2];
+
+    uint count = bit::seq< 0, 21>(control);
+    uint fill  = bit::seq<24,  1>(control);
+    uint word  = bit::seq<26,  1>(control);
+
+    if ((src & 0x0E00'0000) == 0)
+        return;
+
+    Access access = Access::NonSequential;
+
+    if (word)
+    {
+        src &= ~0x3;
+        dst &= ~0x3;
+
+        u32 value = fill ? readWord(src) : 0;
+        for (uint x = 0; x < count; ++x)
+        {
+            if (!fill)
+                value = readWord(src + 4 * x, access);
+
+            writeWord(dst + 4 * x, value, access);
+            access = Access::Sequential;
+            idle(4);
+        }
+    }
+    else
+    {
+        src &= ~0x1;
+        dst &= ~0x1;
+
+        u16 value = fill ? readHalf(src) : 0;
+        for (uint x = 0; x < count; ++x)
+        {
+            if (!fill)
+                value = readHalf(src + 2 * x, access);
+
+            writeHalf(dst + 2 * x, value, access);
+            access = Access::Sequential;
+            idle(4);
+        }
+    }
+}
+
+void Arm::swiCpuFastSet()
+{
+    u32 src = gprs[0] & ~0x3;
+    u32 dst = gprs[1] & ~0x3;
+    u32 control = gprs[2];
+
+    uint count = (bit::seq<0, 21>(control) + 7) & ~0x7;
+    uint fill  =  bit::seq<24, 1>(control);
+
+    if ((src & 0x0E00'0000) == 0)
+        return;
+
+    u32 value = fill ? readWord(src) : 0;
+    for (uint x = 0; x < count; x += 8)
+    {
+        Access access = Access::NonSequential;
+        if (!fill)
+        {
+            shell::array<u32, 8> words;
+            for (uint y = 0; y < 8; ++y)
+            {
+                words[y] = readWord(src + 4 * (x + y), access);
+                access = Access::Sequential;
+            }
+
+            access = Access::NonSequential;
+            for (uint y = 0; y < 8; ++y)
+            {
+                writeWord(dst + 4 * (x + y), words[y], access);
+                access = Access::Sequential;
+            }
+        }
+        else
+        {
+            for (uint y = 0; y < 8; ++y)
+            {
+                writeWord(dst + 4 * (x + y), value, access);
+                access = Access::Sequential;
+            }
+        }
+        idle(6);
+    }
+}
+
+void Arm::swiBgAffineSet()
+{
+    u32 src = gprs[0];
+    u32 dst = gprs[1];
+
+    for (uint count = gprs[2]; count--; src += 20, dst += 16)
+    {
+        s32 ox = readWord(src +  0);
+        s32 oy = readWord(src +  4, Access::Sequential);
+        s32 cx = static_cast<s16>(readHalf(src +  8));
+        s32 cy = static_cast<s16>(readHalf(src + 10, Access::Sequential));
+        s32 sx = static_cast<s16>(readHalf(src + 12, Access::Sequential));
+        s32 sy = static_cast<s16>(readHalf(src + 14, Access::Sequential));
+
+        uint angle = readHalf(src + 16, Access::Sequential) >> 8;
+
+        s32 sin = kSine[angle];
+        s32 cos = kSine[(angle + 64) & 0xFF];
+
+        s32 pa =  (sx * cos) >> 14;
+        s32 pb = -(sx * sin) >> 14;
+        s32 pc =  (sy * sin) >> 14;
+        s32 pd =  (sy * cos) >> 14;
+
+        writeHalf(dst +  0, pa);
+        writeHalf(dst +  2, pb, Access::Sequential);
+        writeHalf(dst +  4, pc, Access::Sequential);
+        writeHalf(dst +  6, pd, Access::Sequential);
+        writeWord(dst +  8, ox - pa * cx - pb * cy, Access::Sequential);
+        writeWord(dst + 12, oy - pc * cx - pd * cy, Access::Sequential);
+
+        idle(32);
+    }
+}
+
+void Arm::swiObjAffineSet()
+{
+    u32 src = gprs[0];
+    u32 dst = gprs[1];
+    u32 offset = gprs[3];
+
+    for (uint count = gprs[2]; count--; src += 8, dst += 4 * offset)
+    {
+        s32 sx = static_cast<s16>(readHalf(src + 0));
+        s32 sy = static_cast<s16>(readHalf(src + 2, Access::Sequential));
+
+        uint angle = readHalf(src + 4, Access::Sequential) >> 8;
+
+        s32 sin = kSine[angle];
+        s32 cos = kSine[(angle + 64) & 0xFF];
+
+        writeHalf(dst + 0 * offset,  (sx * cos) >> 14);
+        writeHalf(dst + 1 * offset, -(sx * sin) >> 14);
+        writeHalf(dst + 2 * offset,  (sy * sin) >> 14);
+        writeHalf(dst + 3 * offset,  (sy * cos) >> 14);
+
+        idle(20);
+    }
+}
+
+void Arm::swiLz77(bool vram)
+{
+    u32 src = gprs[0];
+    u32 size = readWord(src & ~0x3) >> 8;
+    src = (src & ~0x3) + 4;
+
+    Uncompressed data(*this, gprs[1], vram);
+
+    while (data.size < size)
+    {
+        u8 flags = readByte(src++);
+        for (uint x = 0; x < 8 && data.size < size; ++x, flags <<= 1)
+        {
+            if (flags & 0x80)
+            {
+                u8 byte1 = readByte(src++, Access::Sequential);
+                u8 byte2 = readByte(src++, Access::Sequential);
+
+                uint length = (byte1 >> 4) + 3;
+                uint offset = (byte2 | (byte1 & 0xF) << 8) + 1;
+
+                for (; length && data.size < size; --length)
+                    data.write(data.read(offset));
+            }
+            else
+            {
+                data.write(readByte(src++, Access::Sequential));
+            }
+            idle(4);
+        }
+    }
+}
+
+void Arm::swiHuffman()
+{
+    u32 src = gprs[0] & ~0x3;
+    u32 dst = gprs[1] & ~0x3;
+
+    u32 header = readWord(src);
+    u32 size   = header >> 8;
+    uint bits  = header & 0xF;
+
+    if (bits != 4 && bits != 8)
+        return;
+
+    u32 tree   = src + 4;
+    u32 stream = tree + 2 * (readByte(tree) + 1);
+    u32 root   = tree + 1;
+    u32 node   = root;
+
+    u32 value = 0;
+    uint shift = 0;
+
+    while (size > 0)
+    {
+        u32 data = readWord(stream);
+        stream += 4;
+
+        for (uint x = 32; x-- && size > 0; )
+        {
+            uint bit  = (data >> x) & 0x1;
+            u8   info = readByte(node);
+            u32  next = (node & ~0x1) + 2 * (info & 0x3F) + 2 + bit;
+
+            if (info & (0x80 >> bit))
+            {
+                value |= readByte(next) << shift;
+                shift += bits;
+                node = root;
+
+                if (shift == 32)
+                {
+                    writeWord(dst, value);
+                    dst += 4;
+                    size = size > 4 ? size - 4 : 0;
+                    value = 0;
+                    shift = 0;
+                }
+            }
+            else
+            {
+                node = next;
+            }
+            idle(3);
+        }
+    }
+}
+
+void Arm::swiRunLength(bool vram)
+{
+    u32 src = gprs[0];
+    u32 size = readWord(src & ~0x3) >> 8;
+    src = (src & ~0x3) + 4;
+
+    Uncompressed data(*this, gprs[1], vram);
+
+    while (data.size < size)
+    {
+        u8 flag = readByte(src++);
+        if (flag & 0x80)
+        {
+            u8 byte = readByte(src++, Access::Sequential);
+            for (uint length = (flag & 0x7F) + 3; length && data.size < size; --length)
+                data.write(byte);
+        }
+        else
+        {
+            for (uint length = (flag & 0x7F) + 1; length && data.size < size; --length)
+                data.write(readByte(src++, Access::Sequential));
+        }
+        idle(6);
+    }
+}
+
+Arm::Uncompressed::Uncompressed(Arm& arm, u32 dst, bool vram)
+    : arm(arm), dst(vram ? dst & ~0x1 : dst), vram(vram)
+{
+
+}
+
+u8 Arm::Uncompressed::read(uint offset)
+{
+    if (vram && offset == 1 && (size & 0x1))
+        return pending;
+
+    return arm.readByte(dst + size - offset);
+}
+
+void Arm::Uncompressed::write(u8 byte)
+{
+    if (vram && !(size & 0x1))
+    {
+        pending = byte;
+    }
+    else
+    {
+        if (vram)
+            arm.writeHalf(dst + size - 1, pending | byte << 8, access);
+        else
+            arm.writeByte(dst + size, byte, access);
+
+        access = Access::Sequential;
+    }
+    size++;
+}
@@ -294,8 +294,8 @@ void Arm::Arm_MultiplyLong(u32 instr)
 
     if (kFlags)
     {
-        cpsr.z = res == 0;
-        cpsr.n = bit::msb(res);
+        cpsr.setZ(res == 0);
+        cpsr.setN(bit::msb(res));
     }
 
     dst_lo = static_cast<u32>(res);
@@ -504,15 +504,21 @@ void Arm::Arm_BlockDataTransfer(u32 instr)
 
         Access access = Access::NonSequential;
 
+        u64 cycles = 0;
+        u32* data = transferPage(addr + 4 * pre_index, bit::popcnt(rlist), !kLoad, cycles);
+
         if (kLoad)
         {
             if (rlist & (1 << rn))
                 writeback = false;
 
+            if (data)
+                tickRam(cycles);
+
             for (uint x : bit::iterate(rlist))
             {
                 addr += 4 * pre_index;
-                regs[x] = readWord(addr, access);
+                regs[x] = data ? *data++ : readWord(addr, access);
                 addr += 4 * pre_index ^ 0x4;
                 access = Access::Sequential;
             }
@@ -535,10 +541,16 @@ void Arm::Arm_BlockDataTransfer(u32 instr)
                         : base + (kIncrement ? 4 : -4) * bit::popcnt(rlist);
 
                 addr += 4 * pre_index;
-                writeWord(addr, value, access);
+                if (data)
+                    *data++ = value;
+                else
+                    writeWord(addr, value, access);
                 addr += 4 * pre_index ^ 0x4;
                 access = Access::Sequential;
             }
+
+            if (data)
+                tickRam(cycles);
         }
     }
     else
@@ -606,6 +618,9 @@ void Arm::Arm_SingleDataSwap(u32 instr)
 template<u32 kInstr>
 void Arm::Arm_SoftwareInterrupt(u32 instr)
 {
+    if (isHle() && hleSwi(bit::seq<16, 8>(instr)))
+        return;
+
     interruptSw();
 }
 
@@ -639,21 +654,21 @@ constexpr Arm::Instruction32 Arm::Arm_Decode()
     constexpr auto kDehash = dehashArm(kHash);
     constexpr auto kDecode = decodeArm(kHash);
 
-    if constexpr (kDecode == InstructionArm::BranchExchange)               return &Arm::Arm_BranchExchange<kDehash>;
-    if constexpr (kDecode == InstructionArm::BranchLink)                   return &Arm::Arm_BranchLink<kDehash>;
-    if constexpr (kDecode == InstructionArm::DataProcessing)               return &Arm::Arm_DataProcessing<kDehash>;
-    if constexpr (kDecode == InstructionArm::StatusTransfer)               return &Arm::Arm_StatusTransfer<kDehash>;
-    if constexpr (kDecode == InstructionArm::Multiply)                     return &Arm::Arm_Multiply<kDehash>;
-    if constexpr (kDecode == InstructionArm::MultiplyLong)                 return &Arm::Arm_MultiplyLong<kDehash>;
-    if constexpr (kDecode == InstructionArm::SingleDataTransfer)           return &Arm::Arm_SingleDataTransfer<kDehash>;
-    if constexpr (kDecode == InstructionArm::HalfSignedDataTransfer)       return &Arm::Arm_HalfSignedDataTransfer<kDehash>;
-    if constexpr (kDecode == InstructionArm::BlockDataTransfer)            return &Arm::Arm_BlockDataTransfer<kDehash>;
-    if constexpr (kDecode == InstructionArm::SingleDataSwap)               return &Arm::Arm_SingleDataSwap<kDehash>;
-    if constexpr (kDecode == InstructionArm::SoftwareInterrupt)            return &Arm::Arm_SoftwareInterrupt<kDehash>;
-    if constexpr (kDecode == InstructionArm::CoprocessorDataOperations)    return &Arm::Arm_CoprocessorDataOperations<kDehash>;
-    if constexpr (kDecode == InstructionArm::CoprocessorDataTransfers)     return &Arm::Arm_CoprocessorDataTransfers<kDehash>;
-    if constexpr (kDecode == InstructionArm::CoprocessorRegisterTransfers) return &Arm::Arm_CoprocessorRegisterTransfers<kDehash>;
-    if constexpr (kDecode == InstructionArm::Undefined)                    return &Arm::Arm_Undefined<kDehash>;
+    if constexpr (kDecode == InstructionArm::BranchExchange)               return &Arm_Handler<&Arm::Arm_BranchExchange<kDehash>>;
+    if constexpr (kDecode == InstructionArm::BranchLink)                   return &Arm_Handler<&Arm::Arm_BranchLink<kDehash>>;
+    if constexpr (kDecode == InstructionArm::DataProcessing)               return &Arm_Handler<&Arm::Arm_DataProcessing<kDehash>>;
+    if constexpr (kDecode == InstructionArm::StatusTransfer)               return &Arm_Handler<&Arm::Arm_StatusTransfer<kDehash>>;
+    if constexpr (kDecode == InstructionArm::Multiply)                     return &Arm_Handler<&Arm::Arm_Multiply<kDehash>>;
+    if constexpr (kDecode == InstructionArm::MultiplyLong)                 return &Arm_Handler<&Arm::Arm_MultiplyLong<kDehash>>;
+    if constexpr (kDecode == InstructionArm::SingleDataTransfer)           return &Arm_Handler<&Arm::Arm_SingleDataTransfer<kDehash>>;
+    if constexpr (kDecode == InstructionArm::HalfSignedDataTransfer)       return &Arm_Handler<&Arm::Arm_HalfSignedDataTransfer<kDehash>>;
+    if constexpr (kDecode == InstructionArm::BlockDataTransfer)            return &Arm_Handler<&Arm::Arm_BlockDataTransfer<kDehash>>;
+    if constexpr (kDecode == InstructionArm::SingleDataSwap)               return &Arm_Handler<&Arm::Arm_SingleDataSwap<kDehash>>;
+    if constexpr (kDecode == InstructionArm::SoftwareInterrupt)            return &Arm_Handler<&Arm::Arm_SoftwareInterrupt<kDehash>>;
+    if constexpr (kDecode == InstructionArm::CoprocessorDataOperations)    return &Arm_Handler<&Arm::Arm_CoprocessorDataOperations<kDehash>>;
+    if constexpr (kDecode == InstructionArm::CoprocessorDataTransfers)     return &Arm_Handler<&Arm::Arm_CoprocessorDataTransfers<kDehash>>;
+    if constexpr (kDecode == InstructionArm::CoprocessorRegisterTransfers) return &Arm_Handler<&Arm::Arm_CoprocessorRegisterTransfers<kDehash>>;
+    if constexpr (kDecode == InstructionArm::Undefined)                    return &Arm_Handler<&Arm::Arm_Undefined<kDehash>>;
 }
 
 #define DECODE0001(hash) Arm_Decode<hash>(),
@@ -403,9 +403,15 @@ void Arm::Thumb_PushPopRegisters(u16 instr)
 
     if (kPop)
     {
+        u64 cycles = 0;
+        u32* data = transferPage(sp, bit::popcnt(rlist), false, cycles);
+
+        if (data)
+            tickRam(cycles);
+
         for (uint x : bit::iterate(rlist))
         {
-            regs[x] = readWord(sp, access);
+            regs[x] = data ? *data++ : readWord(sp, access);
             access = Access::Sequential;
             sp += 4;
         }
@@ -420,13 +426,21 @@ void Arm::Thumb_PushPopRegisters(u16 instr)
         sp -= 4 * bit::popcnt(rlist);
 
         u32 addr = sp;
+        u64 cycles = 0;
+        u32* data = transferPage(addr, bit::popcnt(rlist), true, cycles);
 
         for (uint x : bit::iterate(rlist))
         {
-            writeWord(addr, regs[x], access);
+            if (data)
+                *data++ = regs[x];
+            else
+                writeWord(addr, regs[x], access);
             access = Access::Sequential;
             addr += 4;
         }
+
+        if (data)
+            tickRam(cycles);
     }
 }
 
@@ -447,14 +461,20 @@ void Arm::Thumb_LoadStoreMultiple(u16 instr)
 
     if (rlist != 0)
     {
+        u64 cycles = 0;
+        u32* data = transferPage(addr, bit::popcnt(rlist), !kLoad, cycles);
+
         if (kLoad)
         {
             if (rlist & (1 << kRb))
                 writeback = false;
 
+            if (data)
+                tickRam(cycles);
+
             for (uint x : bit::iterate(rlist))
             {
-                regs[x] = readWord(addr, access);
+                regs[x] = data ? *data++ : readWord(addr, access);
                 access = Access::Sequential;
                 addr += 4;
             }
@@ -470,10 +490,16 @@ void Arm::Thumb_LoadStoreMultiple(u16 instr)
                         ? base
                         : base + 4 * bit::popcnt(rlist);
 
-                writeWord(addr, value, access);
+                if (data)
+                    *data++ = value;
+                else
+                    writeWord(addr, value, access);
                 access = Access::Sequential;
                 addr += 4;
             }
+
+            if (data)
+                tickRam(cycles);
         }
     }
     else
@@ -514,6 +540,9 @@ void Arm::Thumb_ConditionalBranch(u16 instr)
 template<u16 kInstr>
 void Arm::Thumb_SoftwareInterrupt(u16 instr)
 {
+    if (isHle() && hleSwi(bit::seq<0, 8>(instr)))
+        return;
+
     interruptSw();
 }
 
@@ -567,26 +596,26 @@ constexpr Arm::Instruction16 Arm::Thumb_Decode()
     constexpr auto kDehash = dehashThumb(kHash);
     constexpr auto kDecode = decodeThumb(kHash);
 
-    if constexpr (kDecode == InstructionThumb::MoveShiftedRegister)      return &Arm::Thumb_MoveShiftedRegister<kDehash>;
-    if constexpr (kDecode == InstructionThumb::AddSubtract)              return &Arm::Thumb_AddSubtract<kDehash>;
-    if constexpr (kDecode == InstructionThumb::ImmediateOperations)      return &Arm::Thumb_ImmediateOperations<kDehash>;
-    if constexpr (kDecode == InstructionThumb::AluOperations)            return &Arm::Thumb_AluOperations<kDehash>;
-    if constexpr (kDecode == InstructionThumb::HighRegisterOperations)   return &Arm::Thumb_HighRegisterOperations<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LoadPcRelative)           return &Arm::Thumb_LoadPcRelative<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LoadStoreRegisterOffset)  return &Arm::Thumb_LoadStoreRegisterOffset<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LoadStoreByteHalf)        return &Arm::Thumb_LoadStoreByteHalf<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LoadStoreImmediateOffset) return &Arm::Thumb_LoadStoreImmediateOffset<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LoadStoreHalf)            return &Arm::Thumb_LoadStoreHalf<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LoadStoreSpRelative)      return &Arm::Thumb_LoadStoreSpRelative<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LoadRelativeAddress)      return &Arm::Thumb_LoadRelativeAddress<kDehash>;
-    if constexpr (kDecode == InstructionThumb::AddOffsetSp)              return &Arm::Thumb_AddOffsetSp<kDehash>;
-    if constexpr (kDecode == InstructionThumb::PushPopRegisters)         return &Arm::Thumb_PushPopRegisters<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LoadStoreMultiple)        return &Arm::Thumb_LoadStoreMultiple<kDehash>;
-    if constexpr (kDecode == InstructionThumb::ConditionalBranch)        return &Arm::Thumb_ConditionalBranch<kDehash>;
-    if constexpr (kDecode == InstructionThumb::SoftwareInterrupt)        return &Arm::Thumb_SoftwareInterrupt<kDehash>;
-    if constexpr (kDecode == InstructionThumb::UnconditionalBranch)      return &Arm::Thumb_UnconditionalBranch<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LongBranchLink)           return &Arm::Thumb_LongBranchLink<kDehash>;
-    if constexpr (kDecode == InstructionThumb::Undefined)                return &Arm::Thumb_Undefined<kDehash>;
+    if constexpr (kDecode == InstructionThumb::MoveShiftedRegister)      return &Thumb_Handler<&Arm::Thumb_MoveShiftedRegister<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::AddSubtract)              return &Thumb_Handler<&Arm::Thumb_AddSubtract<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::ImmediateOperations)      return &Thumb_Handler<&Arm::Thumb_ImmediateOperations<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::AluOperations)            return &Thumb_Handler<&Arm::Thumb_AluOperations<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::HighRegisterOperations)   return &Thumb_Handler<&Arm::Thumb_HighRegisterOperations<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LoadPcRelative)           return &Thumb_Handler<&Arm::Thumb_LoadPcRelative<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LoadStoreRegisterOffset)  return &Thumb_Handler<&Arm::Thumb_LoadStoreRegisterOffset<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LoadStoreByteHalf)        return &Thumb_Handler<&Arm::Thumb_LoadStoreByteHalf<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LoadStoreImmediateOffset) return &Thumb_Handler<&Arm::Thumb_LoadStoreImmediateOffset<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LoadStoreHalf)            return &Thumb_Handler<&Arm::Thumb_LoadStoreHalf<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LoadStoreSpRelative)      return &Thumb_Handler<&Arm::Thumb_LoadStoreSpRelative<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LoadRelativeAddress)      return &Thumb_Handler<&Arm::Thumb_LoadRelativeAddress<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::AddOffsetSp)              return &Thumb_Handler<&Arm::Thumb_AddOffsetSp<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::PushPopRegisters)         return &Thumb_Handler<&Arm::Thumb_PushPopRegisters<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LoadStoreMultiple)        return &Thumb_Handler<&Arm::Thumb_LoadStoreMultiple<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::ConditionalBranch)        return &Thumb_Handler<&Arm::Thumb_ConditionalBranch<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::SoftwareInterrupt)        return &Thumb_Handler<&Arm::Thumb_SoftwareInterrupt<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::UnconditionalBranch)      return &Thumb_Handler<&Arm::Thumb_UnconditionalBranch<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LongBranchLink)           return &Thumb_Handler<&Arm::Thumb_LongBranchLink<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::Undefined)                return &Thumb_Handler<&Arm::Thumb_Undefined<kDehash>>;
 }
 
 #define DECODE0001(hash) Thumb_Decode<hash>(),
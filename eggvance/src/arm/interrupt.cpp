@@ -21,6 +21,8 @@ void Arm::raise(Irq irq, u64 late)
 
 void Arm::interruptHw()
 {
+    idle_loop = 0;
+
     Psr saved = cpsr;
     switchMode(Psr::Mode::Irq);
     spsr = saved;
@@ -31,6 +33,9 @@ void Arm::interruptHw()
     cpsr.t = 0;
     cpsr.i = 1;
 
+    if (isHle())
+        hleIrqEntry();
+
     flushWord();
     state &= ~State::Thumb;
 }
@@ -73,6 +78,11 @@ void Arm::interruptHandle(u64 late)
     }
 }
 
+void Arm::onInterruptDelay(u64 late)
+{
+    state |= State::Irq;
+}
+
 bool Arm::Interrupt::isServable() const
 {
     return enable & request;
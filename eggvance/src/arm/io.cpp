@@ -44,43 +44,31 @@ void WaitControl::write(uint index, u8 byte)
     update();
 }
 
-u64 WaitControl::waitHalf(u32 addr, Access access) const
-{
-    return wait.half[(addr >> 25) & 0x3][uint(access)];
-}
-
-u64 WaitControl::waitWord(u32 addr, Access access) const
-{
-    return wait.word[(addr >> 25) & 0x3][uint(access)];
-}
-
 void WaitControl::update()
 {
-    static constexpr u64 kNonSeq[4] = { 5, 4, 3, 9 };
-    static constexpr u64 kWs0Seq[2] = { 3, 2 };
-    static constexpr u64 kWs1Seq[2] = { 5, 2 };
-    static constexpr u64 kWs2Seq[2] = { 9, 2 };
+    static constexpr u8 kNonSeq[4] = { 5, 4, 3, 9 };
+    static constexpr u8 kWs0Seq[2] = { 3, 2 };
+    static constexpr u8 kWs1Seq[2] = { 5, 2 };
+    static constexpr u8 kWs2Seq[2] = { 9, 2 };
 
     constexpr uint kN = uint(Access::NonSequential);
     constexpr uint kS = uint(Access::Sequential);
 
-    wait.half[0][kN] = kNonSeq[ws0_n];
-    wait.word[0][kN] = kNonSeq[ws0_n] + kWs0Seq[ws0_s];
-    wait.half[1][kN] = kNonSeq[ws1_n];
-    wait.word[1][kN] = kNonSeq[ws1_n] + kWs1Seq[ws1_s];
-    wait.half[2][kN] = kNonSeq[ws2_n];
-    wait.word[2][kN] = kNonSeq[ws2_n] + kWs2Seq[ws2_s];
-    wait.half[3][kN] = kNonSeq[sram];
-    wait.word[3][kN] = kNonSeq[sram];
-        
-    wait.half[0][kS] = kWs0Seq[ws0_s];
-    wait.word[0][kS] = kWs0Seq[ws0_s] * 2;
-    wait.half[1][kS] = kWs1Seq[ws1_s];
-    wait.word[1][kS] = kWs1Seq[ws1_s] * 2;
-    wait.half[2][kS] = kWs2Seq[ws2_s];
-    wait.word[2][kS] = kWs2Seq[ws2_s] * 2;
-    wait.half[3][kS] = kNonSeq[sram];
-    wait.word[3][kS] = kNonSeq[sram];
+    const u8 non[4] = { kNonSeq[ws0_n], kNonSeq[ws1_n], kNonSeq[ws2_n], kNonSeq[sram] };
+    const u8 seq[4] = { kWs0Seq[ws0_s], kWs1Seq[ws1_s], kWs2Seq[ws2_s], kNonSeq[sram] };
+
+    for (uint x = 0; x < 4; ++x)
+    {
+        bool save = x == 3;
+
+        wait.cycles[x][0][kN] = non[x];
+        wait.cycles[x][1][kN] = non[x] + (save ? 0 : seq[x]);
+        wait.cycles[x][0][kS] = seq[x];
+        wait.cycles[x][1][kS] = seq[x] * (save ? 1 : 2);
+
+        wait.prefetch_skip[x] = non[x] - seq[x];
+        wait.prefetch_size[x] = seq[x] * 8;
+    }
 }
 
 InterruptMaster::operator bool() const
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <shell/array.h>
+#include <shell/macros.h>
 
 #include "constants.h"
 #include "base/register.h"
@@ -24,8 +25,25 @@ class WaitControl : public Register<u16>
 
     void write(uint index, u8 byte);
 
-    u64 waitHalf(u32 addr, Access access) const;
-    u64 waitWord(u32 addr, Access access) const;
+    SHELL_INLINE u64 waitHalf(u32 addr, Access access) const
+    {
+        return wait.cycles[index(addr)][0][uint(access)];
+    }
+
+    SHELL_INLINE u64 waitWord(u32 addr, Access access) const
+    {
+        return wait.cycles[index(addr)][1][uint(access)];
+    }
+
+    SHELL_INLINE s64 prefetchSkip(u32 addr) const
+    {
+        return wait.prefetch_skip[index(addr)];
+    }
+
+    SHELL_INLINE u64 prefetchSize(u32 addr) const
+    {
+        return wait.prefetch_size[index(addr)];
+    }
 
     uint sram     = 0;
     uint ws0_n    = 0;
@@ -37,12 +55,18 @@ class WaitControl : public Register<u16>
     uint prefetch = 0;
 
 private:
+    static SHELL_INLINE uint index(u32 addr)
+    {
+        return (addr >> 25) & 0x3;
+    }
+
     void update();
 
     struct WaitStates
     {
-        shell::array<u64, 4, 2> half = {};
-        shell::array<u64, 4, 2> word = {};
+        shell::array<u8, 4, 2, 2> cycles = {};
+        shell::array<s8, 4> prefetch_skip = {};
+        shell::array<u8, 4> prefetch_size = {};
     } wait;
 };
 
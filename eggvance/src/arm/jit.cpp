@@ -0,0 +1,730 @@
+#include "jit.h"
+
+#include <algorithm>
+#include <iterator>
+#include <shell/predef.h>
+
+#if SHELL_OS_WINDOWS
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include "arm.h"
+#include "decode.h"
+#include "base/config.h"
+#include "scheduler/scheduler.h"
+
+#if SHELL_OS_WINDOWS
+static constexpr Reg kArg0 = Reg::Rcx;
+static constexpr Reg kArg1 = Reg::Rdx;
+static constexpr u8  kFrame = 40;
+#else
+static constexpr Reg kArg0 = Reg::Rdi;
+static constexpr Reg kArg1 = Reg::Rsi;
+static constexpr u8  kFrame = 8;
+#endif
+
+template<typename T>
+static Mem field(const T& value)
+{
+    return { Reg::Rbx, static_cast<s32>(reinterpret_cast<const u8*>(&value) - reinterpret_cast<const u8*>(&arm)) };
+}
+
+Jit::~Jit()
+{
+    if (!memory)
+        return;
+
+    #if SHELL_OS_WINDOWS
+    VirtualFree(memory, 0, MEM_RELEASE);
+    #else
+    munmap(memory, kCapacity);
+    #endif
+}
+
+bool Jit::isSupported()
+{
+    return JIT_SUPPORTED;
+}
+
+void Jit::protect(std::size_t offset, std::size_t size, bool write)
+{
+    std::size_t begin = offset & ~(kPageSize - 1);
+    std::size_t end   = std::min<std::size_t>((offset + size + kPageSize - 1) & ~(kPageSize - 1), kCapacity);
+
+    #if SHELL_OS_WINDOWS
+    DWORD previous;
+    VirtualProtect(memory + begin, end - begin, write ? PAGE_READWRITE : PAGE_EXECUTE_READ, &previous);
+    #else
+    mprotect(memory + begin, end - begin, write ? PROT_READ | PROT_WRITE : PROT_READ | PROT_EXEC);
+    #endif
+}
+
+template<typename BlockCache>
+bool Jit::run(BlockCache& cache)
+{
+    auto& block = cache.block();
+
+    if (arm.state & Arm::State::Irq)
+        return false;
+
+    if (arm.pipe[0] != block.entries[0].instr || arm.pipe[1] != block.entries[1].instr)
+        return false;
+
+    Code code = block.native;
+    if (!code)
+    {
+        if (!JIT_SUPPORTED || !config.jit)
+            return false;
+
+        if (block.epoch != epoch)
+        {
+            if (++block.hits < kThreshold)
+                return false;
+
+            block.hits  = 0;
+            block.code  = compile(block, cache.invalidations());
+            block.epoch = block.code ? epoch : 0;
+
+            if (!block.code)
+                return false;
+        }
+        code = block.code;
+    }
+
+    arm.cpsr.resolve();
+
+    uint count = code();
+    if (count == 0)
+        return false;
+
+    arm.instructions += count - 1;
+
+    cache.skip(count - 1);
+
+    return true;
+}
+
+template bool Jit::run(Arm::BlockCacheArm& cache);
+template bool Jit::run(Arm::BlockCacheThumb& cache);
+
+template<typename Block>
+Jit::Code Jit::compile(const Block& block, const u64& invalidations)
+{
+    using Integral = decltype(Block::Entry::instr);
+
+    constexpr bool kThumb = sizeof(Integral) == 2;
+    constexpr uint kSize  = sizeof(Integral);
+    constexpr std::size_t kReserve = 320 * Block::kMaxSize + 256;
+
+    if (!JIT_SUPPORTED)
+        return nullptr;
+
+    if (!memory)
+    {
+        #if SHELL_OS_WINDOWS
+        memory = static_cast<u8*>(VirtualAlloc(nullptr, kCapacity, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+        #else
+        void* data = mmap(nullptr, kCapacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        memory = data != MAP_FAILED ? static_cast<u8*>(data) : nullptr;
+        #endif
+
+        if (!memory)
+            return nullptr;
+    }
+
+    // Compiled from the dispatcher, so this includes the accuracy tier
+    uint state = arm.state;
+
+    if (kCapacity - used < kReserve)
+    {
+        used = 0;
+        epoch++;
+    }
+
+    auto native = [this](Emitter& emitter, Integral instr)
+    {
+        if constexpr (kThumb)
+            return compileThumb(emitter, instr);
+        else
+            return compileArm(emitter, instr);
+    };
+
+    shell::array<bool, Block::kMaxSize> natives = {};
+    {
+        Emitter counter(nullptr, 0);
+
+        hosts.fill(kMemory);
+        uses.fill(0);
+        for (uint x = 0; x < block.size; ++x)
+            natives[x] = native(counter, block.entries[x].instr);
+
+        allocate();
+    }
+
+    Emitter emitter(memory + used, kReserve);
+    protect(used, kReserve, true);
+
+    emitter.push(Reg::Rbx);
+    emitter.push(Reg::Rbp);
+    for (Reg host : kHosts)
+        emitter.push(host);
+    emitter.alu64(Alu::Sub, Reg::Rsp, kFrame);
+    emitter.mov64(Reg::Rbx, reinterpret_cast<u64>(&arm));
+    emitter.mov64(Reg::Rax, reinterpret_cast<u64>(&invalidations));
+    emitter.mov64(Reg::Rbp, Mem{ Reg::Rax, 0 });
+    reload(emitter);
+
+    std::vector<std::size_t> exits;
+    std::vector<std::size_t> spills;
+
+    for (uint x = 0; x < block.size; ++x)
+    {
+        const auto& entry = block.entries[x];
+
+        if (block.fetch && (x == 0 || !natives[x - 1]))
+        {
+            uint last = x;
+            while (last + 1 < block.size && natives[last])
+                last++;
+
+            u32 cycles = block.fetch * (last - x + 1);
+
+            emitter.mov64(Reg::Rcx, reinterpret_cast<u64>(&scheduler.countdown));
+            emitter.mov(Reg::Rdx, cycles);
+            emitter.cmp64(Reg::Rdx, Mem{ Reg::Rcx, 0 });
+            emitter.mov(Reg::Rax, x);
+            spills.push_back(emitter.jump(Cond::Ge));
+
+            emitter.mov(field(arm.pipe.access), uint(Access::Sequential));
+            emitter.mov64(kArg0, cycles);
+            emitter.call(reinterpret_cast<const void*>(&Jit::tickRam));
+        }
+
+        if (!block.fetch || !natives[x] || x + 1 == block.size)
+        {
+            emitter.mov(field(arm.pc), block.addr + kSize * (x + 2));
+            emitter.mov(field(arm.pipe[0]), block.entries[x + 1].instr);
+            emitter.mov(field(arm.pipe[1]), block.entries[x + 2].instr);
+        }
+
+        if (!block.fetch)
+            emitter.call(reinterpret_cast<const void*>(kThumb ? &Jit::fetchHalf : &Jit::fetchWord));
+
+        if (natives[x])
+        {
+            native(emitter, entry.instr);
+
+            if (!block.fetch && x + 1 < block.size)
+            {
+                emitter.mov(Reg::Rax, x + 1);
+                emitter.alu(Alu::Cmp, field(arm.state), state);
+                spills.push_back(emitter.jump(Cond::Ne));
+            }
+            continue;
+        }
+
+        spill(emitter);
+        if constexpr (kThumb)
+            emitter.mov64(kArg0, reinterpret_cast<u64>(&Arm::instr_thumb[hashThumb(entry.instr)]));
+        else
+            emitter.mov64(kArg0, reinterpret_cast<u64>(&Arm::instr_arm[hashArm(entry.instr)]));
+        emitter.mov(kArg1, entry.instr);
+        emitter.call(reinterpret_cast<const void*>(kThumb ? &Jit::callThumb : &Jit::callArm));
+
+        if (x + 1 < block.size)
+        {
+            emitter.mov(Reg::Rax, x + 1);
+            emitter.alu(Alu::Cmp, field(arm.state), state);
+            exits.push_back(emitter.jump(Cond::Ne));
+            emitter.mov64(Reg::Rcx, reinterpret_cast<u64>(&invalidations));
+            emitter.cmp64(Reg::Rbp, Mem{ Reg::Rcx, 0 });
+            exits.push_back(emitter.jump(Cond::Ne));
+        }
+        reload(emitter);
+    }
+
+    emitter.mov(Reg::Rax, block.size);
+
+    for (auto exit : spills)
+        emitter.bind(exit);
+
+    spill(emitter);
+
+    for (auto exit : exits)
+        emitter.bind(exit);
+
+    emitter.alu64(Alu::Add, Reg::Rsp, kFrame);
+    for (auto host = std::rbegin(kHosts); host != std::rend(kHosts); ++host)
+        emitter.pop(*host);
+    emitter.pop(Reg::Rbp);
+    emitter.pop(Reg::Rbx);
+    emitter.ret();
+
+    protect(used, kReserve, false);
+
+    if (emitter.isFull())
+        return nullptr;
+
+    used += emitter.size();
+
+    return reinterpret_cast<Code>(emitter.begin());
+}
+
+void Jit::allocate()
+{
+    for (Reg host : kHosts)
+    {
+        uint index = std::max_element(uses.begin(), uses.end()) - uses.begin();
+        if (uses[index] == 0)
+            break;
+
+        hosts[index] = host;
+        uses[index] = 0;
+    }
+}
+
+void Jit::spill(Emitter& emitter) const
+{
+    for (uint index = 0; index < hosts.size(); ++index)
+    {
+        if (hosts[index] != kMemory)
+            emitter.mov(field(arm.regs[index]), hosts[index]);
+    }
+}
+
+void Jit::reload(Emitter& emitter) const
+{
+    for (uint index = 0; index < hosts.size(); ++index)
+    {
+        if (hosts[index] != kMemory)
+            emitter.mov(hosts[index], field(arm.regs[index]));
+    }
+}
+
+void Jit::load(Emitter& emitter, Reg dst, uint index)
+{
+    uses[index]++;
+
+    if (hosts[index] != kMemory)
+        emitter.mov(dst, hosts[index]);
+    else
+        emitter.mov(dst, field(arm.regs[index]));
+}
+
+void Jit::store(Emitter& emitter, uint index, Reg src)
+{
+    uses[index]++;
+
+    if (hosts[index] != kMemory)
+        emitter.mov(hosts[index], src);
+    else
+        emitter.mov(field(arm.regs[index]), src);
+}
+
+void Jit::alu(Emitter& emitter, Alu op, Reg dst, uint index)
+{
+    uses[index]++;
+
+    if (hosts[index] != kMemory)
+        emitter.alu(op, dst, hosts[index]);
+    else
+        emitter.alu(op, dst, field(arm.regs[index]));
+}
+
+bool Jit::compileThumb(Emitter& emitter, u16 instr)
+{
+    auto logical = [&]()
+    {
+        emitter.mov(field(arm.cpsr.zero), Reg::Rax);
+        emitter.mov(field(arm.cpsr.sign), Reg::Rax);
+    };
+
+    auto arithmetic = [&](bool sub)
+    {
+        emitter.set(sub ? Cond::Ae : Cond::B, field(arm.cpsr.carry));
+        emitter.set(Cond::O, field(arm.cpsr.overflow));
+        logical();
+    };
+
+    switch (decodeThumb(hashThumb(instr)))
+    {
+    case InstructionThumb::MoveShiftedRegister:
+    {
+        enum class Opcode { Lsl, Lsr, Asr };
+
+        uint rd     = bit::seq< 0, 3>(instr);
+        uint rs     = bit::seq< 3, 3>(instr);
+        uint amount = bit::seq< 6, 5>(instr);
+        uint opcode = bit::seq<11, 2>(instr);
+
+        if (amount == 0 && opcode != Opcode::Lsl)
+            return false;
+
+        load(emitter, Reg::Rax, rs);
+
+        if (amount != 0)
+        {
+            switch (Opcode(opcode))
+            {
+            case Opcode::Lsl: emitter.shift(Sft::Shl, Reg::Rax, amount); break;
+            case Opcode::Lsr: emitter.shift(Sft::Shr, Reg::Rax, amount); break;
+            case Opcode::Asr: emitter.shift(Sft::Sar, Reg::Rax, amount); break;
+
+            default:
+                SHELL_UNREACHABLE;
+                break;
+            }
+            emitter.set(Cond::B, field(arm.cpsr.carry));
+        }
+        store(emitter, rd, Reg::Rax);
+        logical();
+        return true;
+    }
+
+    case InstructionThumb::AddSubtract:
+    {
+        enum class Opcode { AddReg, SubReg, AddImm, SubImm };
+
+        uint rd     = bit::seq<0, 3>(instr);
+        uint rs     = bit::seq<3, 3>(instr);
+        uint rn     = bit::seq<6, 3>(instr);
+        uint opcode = bit::seq<9, 2>(instr);
+
+        load(emitter, Reg::Rax, rs);
+
+        switch (Opcode(opcode))
+        {
+        case Opcode::AddReg: alu(emitter, Alu::Add, Reg::Rax, rn); break;
+        case Opcode::SubReg: alu(emitter, Alu::Sub, Reg::Rax, rn); break;
+        case Opcode::AddImm: emitter.alu(Alu::Add, Reg::Rax, rn); break;
+        case Opcode::SubImm: emitter.alu(Alu::Sub, Reg::Rax, rn); break;
+
+        default:
+            SHELL_UNREACHABLE;
+            break;
+        }
+        store(emitter, rd, Reg::Rax);
+        arithmetic(opcode == Opcode::SubReg || opcode == Opcode::SubImm);
+        return true;
+    }
+
+    case InstructionThumb::ImmediateOperations:
+    {
+        enum class Opcode { Mov, Cmp, Add, Sub };
+
+        uint amount = bit::seq< 0, 8>(instr);
+        uint rd     = bit::seq< 8, 3>(instr);
+        uint opcode = bit::seq<11, 2>(instr);
+
+        if (opcode == Opcode::Mov)
+        {
+            emitter.mov(Reg::Rax, amount);
+            store(emitter, rd, Reg::Rax);
+            emitter.mov(field(arm.cpsr.zero), amount);
+            emitter.mov(field(arm.cpsr.sign), amount);
+            return true;
+        }
+
+        load(emitter, Reg::Rax, rd);
+
+        switch (Opcode(opcode))
+        {
+        case Opcode::Add: emitter.alu(Alu::Add, Reg::Rax, amount); break;
+        case Opcode::Cmp:
+        case Opcode::Sub: emitter.alu(Alu::Sub, Reg::Rax, amount); break;
+
+        default:
+            SHELL_UNREACHABLE;
+            break;
+        }
+
+        if (opcode != Opcode::Cmp)
+            store(emitter, rd, Reg::Rax);
+
+        arithmetic(opcode != Opcode::Add);
+        return true;
+    }
+
+    case InstructionThumb::AluOperations:
+    {
+        enum class Opcode
+        {
+            And, Eor, Lsl, Lsr,
+            Asr, Adc, Sbc, Ror,
+            Tst, Neg, Cmp, Cmn,
+            Orr, Mul, Bic, Mvn
+        };
+
+        uint rd     = bit::seq<0, 3>(instr);
+        uint rs     = bit::seq<3, 3>(instr);
+        uint opcode = bit::seq<6, 4>(instr);
+
+        switch (Opcode(opcode))
+        {
+        case Opcode::And:
+        case Opcode::Eor:
+        case Opcode::Orr:
+        case Opcode::Tst:
+            load(emitter, Reg::Rax, rd);
+            alu(emitter, opcode == Opcode::Eor ? Alu::Xor : opcode == Opcode::Orr ? Alu::Or : Alu::And, Reg::Rax, rs);
+            if (opcode != Opcode::Tst)
+                store(emitter, rd, Reg::Rax);
+            logical();
+            return true;
+
+        case Opcode::Bic:
+            load(emitter, Reg::Rcx, rs);
+            emitter.bitNot(Reg::Rcx);
+            load(emitter, Reg::Rax, rd);
+            emitter.alu(Alu::And, Reg::Rax, Reg::Rcx);
+            store(emitter, rd, Reg::Rax);
+            logical();
+            return true;
+
+        case Opcode::Mvn:
+            load(emitter, Reg::Rax, rs);
+            emitter.bitNot(Reg::Rax);
+            store(emitter, rd, Reg::Rax);
+            logical();
+            return true;
+
+        case Opcode::Cmp:
+        case Opcode::Cmn:
+            load(emitter, Reg::Rax, rd);
+            alu(emitter, opcode == Opcode::Cmp ? Alu::Sub : Alu::Add, Reg::Rax, rs);
+            arithmetic(opcode == Opcode::Cmp);
+            return true;
+
+        case Opcode::Neg:
+            emitter.alu(Alu::Xor, Reg::Rax, Reg::Rax);
+            alu(emitter, Alu::Sub, Reg::Rax, rs);
+            store(emitter, rd, Reg::Rax);
+            arithmetic(true);
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    default:
+        return false;
+    }
+}
+
+bool Jit::compileArm(Emitter& emitter, u32 instr)
+{
+    enum class Opcode
+    {
+        And, Eor, Sub, Rsb,
+        Add, Adc, Sbc, Rsc,
+        Tst, Teq, Cmp, Cmn,
+        Orr, Mov, Bic, Mvn
+    };
+
+    if (decodeArm(hashArm(instr)) != InstructionArm::DataProcessing)
+        return false;
+
+    uint rd     = bit::seq<12, 4>(instr);
+    uint rn     = bit::seq<16, 4>(instr);
+    uint flags  = bit::seq<20, 1>(instr);
+    uint opcode = bit::seq<21, 4>(instr);
+    uint imm_op = bit::seq<25, 1>(instr);
+    uint cond   = bit::seq<28, 4>(instr);
+
+    if (cond != 0xE || rd == 15 || rn == 15)
+        return false;
+
+    bool logical =
+           opcode == Opcode::And
+        || opcode == Opcode::Eor
+        || opcode == Opcode::Orr
+        || opcode == Opcode::Mov
+        || opcode == Opcode::Bic
+        || opcode == Opcode::Mvn
+        || opcode == Opcode::Tst
+        || opcode == Opcode::Teq;
+
+    bool test =
+           opcode == Opcode::Tst
+        || opcode == Opcode::Teq
+        || opcode == Opcode::Cmp
+        || opcode == Opcode::Cmn;
+
+    if (imm_op)
+    {
+        uint value  = bit::seq<0, 8>(instr);
+        uint amount = bit::seq<8, 4>(instr) << 1;
+
+        u32 op2 = amount ? (value >> amount) | (value << (32 - amount)) : value;
+
+        emitter.mov(Reg::Rcx, op2);
+        if (flags && logical && amount)
+            emitter.mov(field(arm.cpsr.carry), op2 >> 31);
+    }
+    else
+    {
+        uint rm     = bit::seq<0, 4>(instr);
+        uint reg_op = bit::seq<4, 1>(instr);
+        uint shift  = bit::seq<5, 2>(instr);
+        uint amount = bit::seq<7, 5>(instr);
+
+        if (rm == 15 || reg_op || (amount == 0 && shift != Arm::Shift::Lsl))
+            return false;
+
+        load(emitter, Reg::Rcx, rm);
+
+        if (amount != 0)
+        {
+            switch (Arm::Shift(shift))
+            {
+            case Arm::Shift::Lsl: emitter.shift(Sft::Shl, Reg::Rcx, amount); break;
+            case Arm::Shift::Lsr: emitter.shift(Sft::Shr, Reg::Rcx, amount); break;
+            case Arm::Shift::Asr: emitter.shift(Sft::Sar, Reg::Rcx, amount); break;
+            case Arm::Shift::Ror: emitter.shift(Sft::Ror, Reg::Rcx, amount); break;
+
+            default:
+                SHELL_UNREACHABLE;
+                break;
+            }
+
+            if (flags && logical)
+                emitter.set(Cond::B, field(arm.cpsr.carry));
+        }
+    }
+
+    switch (Opcode(opcode))
+    {
+    case Opcode::And:
+    case Opcode::Tst:
+        load(emitter, Reg::Rax, rn);
+        emitter.alu(Alu::And, Reg::Rax, Reg::Rcx);
+        break;
+
+    case Opcode::Eor:
+    case Opcode::Teq:
+        load(emitter, Reg::Rax, rn);
+        emitter.alu(Alu::Xor, Reg::Rax, Reg::Rcx);
+        break;
+
+    case Opcode::Orr:
+        load(emitter, Reg::Rax, rn);
+        emitter.alu(Alu::Or, Reg::Rax, Reg::Rcx);
+        break;
+
+    case Opcode::Bic:
+        emitter.bitNot(Reg::Rcx);
+        load(emitter, Reg::Rax, rn);
+        emitter.alu(Alu::And, Reg::Rax, Reg::Rcx);
+        break;
+
+    case Opcode::Mvn:
+        emitter.bitNot(Reg::Rcx);
+        [[fallthrough]];
+
+    case Opcode::Mov:
+        emitter.mov(Reg::Rax, Reg::Rcx);
+        break;
+
+    case Opcode::Add:
+    case Opcode::Cmn:
+        load(emitter, Reg::Rax, rn);
+        emitter.alu(Alu::Add, Reg::Rax, Reg::Rcx);
+        break;
+
+    case Opcode::Sub:
+    case Opcode::Cmp:
+        load(emitter, Reg::Rax, rn);
+        emitter.alu(Alu::Sub, Reg::Rax, Reg::Rcx);
+        break;
+
+    case Opcode::Rsb:
+        emitter.mov(Reg::Rax, Reg::Rcx);
+        alu(emitter, Alu::Sub, Reg::Rax, rn);
+        break;
+
+    case Opcode::Adc:
+        load(emitter, Reg::Rax, rn);
+        emitter.mov(Reg::Rdx, field(arm.cpsr.carry));
+        emitter.alu(Alu::Add, Reg::Rdx, 0xFFFF'FFFF);
+        emitter.alu(Alu::Adc, Reg::Rax, Reg::Rcx);
+        break;
+
+    case Opcode::Sbc:
+    case Opcode::Rsc:
+        if (opcode == Opcode::Sbc)
+        {
+            load(emitter, Reg::Rax, rn);
+        }
+        else
+        {
+            emitter.mov(Reg::Rax, Reg::Rcx);
+            load(emitter, Reg::Rcx, rn);
+        }
+        emitter.mov(Reg::Rdx, field(arm.cpsr.carry));
+        emitter.alu(Alu::Cmp, Reg::Rdx, 1);
+        emitter.alu(Alu::Sbb, Reg::Rax, Reg::Rcx);
+        break;
+
+    default:
+        SHELL_UNREACHABLE;
+        break;
+    }
+
+    if (flags)
+    {
+        if (!logical)
+        {
+            bool sub =
+                   opcode == Opcode::Sub
+                || opcode == Opcode::Rsb
+                || opcode == Opcode::Sbc
+                || opcode == Opcode::Rsc
+                || opcode == Opcode::Cmp;
+
+            emitter.set(sub ? Cond::Ae : Cond::B, field(arm.cpsr.carry));
+            emitter.set(Cond::O, field(arm.cpsr.overflow));
+        }
+        emitter.mov(field(arm.cpsr.zero), Reg::Rax);
+        emitter.mov(field(arm.cpsr.sign), Reg::Rax);
+    }
+
+    if (!test)
+        store(emitter, rd, Reg::Rax);
+
+    return true;
+}
+
+void Jit::callArm(const void* handler, u32 instr)
+{
+    if (arm.cpsr.check(instr >> 28))
+        (*static_cast<const Arm::Instruction32*>(handler))(arm, instr);
+
+    arm.cpsr.resolve();
+}
+
+void Jit::callThumb(const void* handler, u32 instr)
+{
+    (*static_cast<const Arm::Instruction16*>(handler))(arm, static_cast<u16>(instr));
+
+    arm.cpsr.resolve();
+}
+
+void Jit::fetchHalf()
+{
+    arm.tickRom(arm.pc, arm.waitcnt.waitHalf(arm.pc, arm.pipe.access));
+    arm.pipe.access = Access::Sequential;
+}
+
+void Jit::fetchWord()
+{
+    arm.tickRom(arm.pc, arm.waitcnt.waitWord(arm.pc, arm.pipe.access));
+    arm.pipe.access = Access::Sequential;
+}
+
+void Jit::tickRam(u64 cycles)
+{
+    arm.tickRam(cycles);
+}
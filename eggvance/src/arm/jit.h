@@ -0,0 +1,58 @@
+#pragma once
+
+#include <shell/array.h>
+
+#include "emitter.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define JIT_SUPPORTED 1
+#else
+#define JIT_SUPPORTED 0
+#endif
+
+class Jit
+{
+public:
+    friend class JitTest;
+
+    using Code = uint(*)();
+
+    ~Jit();
+
+    static bool isSupported();
+
+    template<typename BlockCache>
+    bool run(BlockCache& cache);
+
+private:
+    static constexpr auto kThreshold = 32;
+    static constexpr auto kCapacity  = 16 * 1024 * 1024;
+    static constexpr auto kPageSize  = 4096;
+    static constexpr Reg kMemory = Reg::Rsp;
+    static constexpr Reg kHosts[4] = { Reg::R12, Reg::R13, Reg::R14, Reg::R15 };
+
+    template<typename Block>
+    Code compile(const Block& block, const u64& invalidations);
+    bool compileThumb(Emitter& emitter, u16 instr);
+    bool compileArm(Emitter& emitter, u32 instr);
+
+    void protect(std::size_t offset, std::size_t size, bool write);
+    void allocate();
+    void spill(Emitter& emitter) const;
+    void reload(Emitter& emitter) const;
+    void load(Emitter& emitter, Reg dst, uint index);
+    void store(Emitter& emitter, uint index, Reg src);
+    void alu(Emitter& emitter, Alu op, Reg dst, uint index);
+
+    static void callArm(const void* handler, u32 instr);
+    static void callThumb(const void* handler, u32 instr);
+    static void fetchHalf();
+    static void fetchWord();
+    static void tickRam(u64 cycles);
+
+    u8* memory = nullptr;
+    std::size_t used = 0;
+    uint epoch = 1;
+    shell::array<uint, 16> uses = {};
+    shell::array<Reg, 16> hosts = {};
+};
@@ -1,33 +1,114 @@
 #include "arm.h"
 
+#include <shell/operators.h>
+
 #include "gamepak/gamepak.h"
 #include "keypad/keypad.h"
 #include "ppu/ppu.h"
 
-enum class Region
+static u32 mirrorRom(u32 addr)
+{
+    return addr & (gamepak.rom.mask - 1);
+}
+
+void Arm::mapPages()
+{
+    using Flag = PageTable::Flag;
+
+    constexpr uint kWorkRam = uint(Flag::Read | Flag::Write | Flag::WriteByte | Flag::Code);
+
+    pages.map(0x0200'0000, 0x0100'0000, ewram->data(), ewram->mirror, kWorkRam, 3, 6);
+    pages.map(0x0300'0000, 0x0100'0000, iwram->data(), iwram->mirror, kWorkRam, 1, 1);
+    pages.map(0x0600'0000, 0x0100'0000, ppu.vram.data(), ppu.vram.mirror, uint(Flag::Read), 1, 2);
+
+    if (gamepak.rom.empty())
+        return;
+
+    pages.map(0x0800'0000, 0x0600'0000, gamepak.rom.data(), mirrorRom, uint(Flag::Read | Flag::Rom), 0, 0);
+
+    for (u32 addr = 0x0800'0000; addr < 0x0E00'0000; addr += 1 << PageTable::kBits)
+    {
+        if (gamepak.isEepromAccess(addr) || gamepak.isEepromAccess(addr + PageTable::kMask))
+            pages.unmap(addr, 1 << PageTable::kBits);
+    }
+    pages.update(waitcnt);
+
+    mapGpio();
+}
+
+void Arm::mapGpio()
+{
+    using Flag = PageTable::Flag;
+
+    code_page = CodePage();
+
+    if (gamepak.rom.empty())
+        return;
+
+    // GPIO registers are only visible in the first ROM page while reads are enabled
+    bool gpio = gamepak.gpio->isAccess(0xC4) && gamepak.gpio->isReadable();
+
+    for (u32 addr = 0x0800'0000; addr < 0x0E00'0000; addr += 1 << PageTable::kBits)
+    {
+        if (mirrorRom(addr) != 0 || gamepak.isEepromAccess(addr) || gamepak.isEepromAccess(addr + PageTable::kMask))
+            continue;
+
+        if (gpio)
+        {
+            pages.unmap(addr, 1 << PageTable::kBits);
+        }
+        else
+        {
+            pages.map(addr, 1 << PageTable::kBits, gamepak.rom.data(), mirrorRom, uint(Flag::Read | Flag::Rom), 0, 0);
+            pages.update(waitcnt, addr, 1 << PageTable::kBits);
+        }
+    }
+}
+
+template<typename Integral>
+SHELL_INLINE bool Arm::readPage(u32 addr, Access access, Integral& value)
 {
-    Bios,
-    Unused,
-    ExternalWorkRam,
-    InternalWorkRam,
-    Io,
-    PaletteRam,
-    VideoRam,
-    Oam,
-    GamePak0L,
-    GamePak0H,
-    GamePak1L,
-    GamePak1H,
-    GamePak2L,
-    GamePak2H,
-    SaveL,
-    SaveH
-};
+    const auto* page = pages.find(addr);
+    if (!page || !(page->flags & PageTable::Flag::Read))
+        return false;
+
+    u64 cycles = page->wait[sizeof(Integral) == 4][uint(access)];
+
+    if (page->flags & PageTable::Flag::Rom)
+        tickRom(addr, cycles);
+    else
+        tickRam(cycles);
+
+    addr &= PageTable::kMask & ~(sizeof(Integral) - 1);
+    value = *reinterpret_cast<const Integral*>(page->data + addr);
+
+    return true;
+}
+
+template<typename Integral>
+SHELL_INLINE bool Arm::writePage(u32 addr, Integral value)
+{
+    const auto* page = pages.find(addr);
+    if (!page || !(page->flags & (sizeof(Integral) == 1 ? PageTable::Flag::WriteByte : PageTable::Flag::Write)))
+        return false;
+
+    tickRam(page->wait[sizeof(Integral) == 4][0]);
+
+    *reinterpret_cast<Integral*>(page->data + (addr & PageTable::kMask & ~(sizeof(Integral) - 1))) = value;
+
+    if (page->flags & PageTable::Flag::Code)
+        invalidate(addr);
+
+    return true;
+}
 
 u8 Arm::readByte(u32 addr, Access access)
 {
     pipe.access = Access::NonSequential;
 
+    if (u8 byte; readPage(addr, access, byte))
+        return byte;
+
     switch (Region(addr >> 24))
     {
     case Region::Bios:
@@ -44,11 +125,11 @@ u8 Arm::readByte(u32 addr, Access access)
 
     case Region::ExternalWorkRam:
         tickRam(3);
-        return ewram.readByte(addr);
+        return ewram->readByte(addr);
 
     case Region::InternalWorkRam:
         tickRam(1);
-        return iwram.readByte(addr);
+        return iwram->readByte(addr);
 
     case Region::Io:
         tickRam(1);
@@ -91,6 +172,9 @@ u16 Arm::readHalf(u32 addr, Access access)
 {
     pipe.access = Access::NonSequential;
 
+    if (u16 half; readPage(addr, access, half))
+        return half;
+
     switch (Region(addr >> 24))
     {
     case Region::Bios:
@@ -107,11 +191,11 @@ u16 Arm::readHalf(u32 addr, Access access)
 
     case Region::ExternalWorkRam:
         tickRam(3);
-        return ewram.readHalf(addr);
+        return ewram->readHalf(addr);
 
     case Region::InternalWorkRam:
         tickRam(1);
-        return iwram.readHalf(addr);
+        return iwram->readHalf(addr);
 
     case Region::Io:
         tickRam(1);
@@ -162,6 +246,9 @@ u32 Arm::readWord(u32 addr, Access access)
 {
     pipe.access = Access::NonSequential;
 
+    if (u32 word; readPage(addr, access, word))
+        return word;
+
     switch (Region(addr >> 24))
     {
     case Region::Bios:
@@ -178,11 +265,11 @@ u32 Arm::readWord(u32 addr, Access access)
 
     case Region::ExternalWorkRam:
         tickRam(6);
-        return ewram.readWord(addr);
+        return ewram->readWord(addr);
 
     case Region::InternalWorkRam:
         tickRam(1);
-        return iwram.readWord(addr);
+        return iwram->readWord(addr);
 
     case Region::Io:
         tickRam(1);
@@ -235,6 +322,9 @@ void Arm::writeByte(u32 addr, u8 byte, Access access)
 {
     pipe.access = Access::NonSequential;
 
+    if (writePage(addr, byte))
+        return;
+
     switch (Region(addr >> 24))
     {
     case Region::Bios:
@@ -244,12 +334,14 @@ void Arm::writeByte(u32 addr, u8 byte, Access access)
 
     case Region::ExternalWorkRam:
         tickRam(3);
-        ewram.writeByte(addr, byte);
+        ewram->writeByte(addr, byte);
+        invalidate(addr);
         break;
 
     case Region::InternalWorkRam:
         tickRam(1);
-        iwram.writeByte(addr, byte);
+        iwram->writeByte(addr, byte);
+        invalidate(addr);
         break;
 
     case Region::Io:
@@ -262,11 +354,13 @@ void Arm::writeByte(u32 addr, u8 byte, Access access)
 
     case Region::PaletteRam:
         tickRam(1);
+        ppu.catchUp();
         ppu.pram.writeByte(addr, byte);
         break;
 
     case Region::VideoRam:
         tickRam(1);
+        ppu.catchUp();
         ppu.vram.writeByte(addr, byte);
         break;
 
@@ -299,6 +393,9 @@ void Arm::writeByte(u32 addr, u8 byte, Access access)
 void Arm::writeHalf(u32 addr, u16 half, Access access)
 {
     pipe.access = Access::NonSequential;
+
+    if (writePage(addr, half))
+        return;
     
     switch (Region(addr >> 24))
     {
@@ -309,12 +406,14 @@ void Arm::writeHalf(u32 addr, u16 half, Access access)
 
     case Region::ExternalWorkRam:
         tickRam(3);
-        ewram.writeHalf(addr, half);
+        ewram->writeHalf(addr, half);
+        invalidate(addr);
         break;
 
     case Region::InternalWorkRam:
         tickRam(1);
-        iwram.writeHalf(addr, half);
+        iwram->writeHalf(addr, half);
+        invalidate(addr);
         break;
 
     case Region::Io:
@@ -328,16 +427,19 @@ void Arm::writeHalf(u32 addr, u16 half, Access access)
 
     case Region::PaletteRam:
         tickRam(1);
+        ppu.catchUp();
         ppu.pram.writeHalf(addr, half);
         break;
 
     case Region::VideoRam:
         tickRam(1);
+        ppu.catchUp();
         ppu.vram.writeHalf(addr, half);
         break;
 
     case Region::Oam:
         tickRam(1);
+        ppu.catchUp();
         ppu.oam.writeHalf(addr, half);
         break;
 
@@ -347,9 +449,16 @@ void Arm::writeHalf(u32 addr, u16 half, Access access)
     case Region::GamePak1H:
     case Region::GamePak2L:
     case Region::GamePak2H:
+    {
         tickRom(addr, waitcnt.waitHalf(addr, access));
+
+        bool readable = gamepak.gpio->isReadable();
         gamepak.write<u16>(addr, half);
+
+        if (readable != gamepak.gpio->isReadable())
+            mapGpio();
         break;
+    }
 
     case Region::SaveL:
     case Region::SaveH:
@@ -366,6 +475,9 @@ void Arm::writeHalf(u32 addr, u16 half, Access access)
 void Arm::writeWord(u32 addr, u32 word, Access access)
 {
     pipe.access = Access::NonSequential;
+
+    if (writePage(addr, word))
+        return;
     
     switch (Region(addr >> 24))
     {
@@ -376,12 +488,14 @@ void Arm::writeWord(u32 addr, u32 word, Access access)
 
     case Region::ExternalWorkRam:
         tickRam(6);
-        ewram.writeWord(addr, word);
+        ewram->writeWord(addr, word);
+        invalidate(addr);
         break;
 
     case Region::InternalWorkRam:
         tickRam(1);
-        iwram.writeWord(addr, word);
+        iwram->writeWord(addr, word);
+        invalidate(addr);
         break;
 
     case Region::Io:
@@ -397,16 +511,19 @@ void Arm::writeWord(u32 addr, u32 word, Access access)
 
     case Region::PaletteRam:
         tickRam(2);
+        ppu.catchUp();
         ppu.pram.writeWord(addr, word);
         break;
 
     case Region::VideoRam:
         tickRam(2);
+        ppu.catchUp();
         ppu.vram.writeWord(addr, word);
         break;
 
     case Region::Oam:
         tickRam(1);
+        ppu.catchUp();
         ppu.oam.writeWord(addr, word);
         break;
 
@@ -416,9 +533,16 @@ void Arm::writeWord(u32 addr, u32 word, Access access)
     case Region::GamePak1H:
     case Region::GamePak2L:
     case Region::GamePak2H:
+    {
         tickRom(addr, waitcnt.waitWord(addr, access));
+
+        bool readable = gamepak.gpio->isReadable();
         gamepak.write<u32>(addr, word);
+
+        if (readable != gamepak.gpio->isReadable())
+            mapGpio();
         break;
+    }
 
     case Region::SaveL:
     case Region::SaveH:
@@ -437,6 +561,9 @@ u32 Arm::readUnused() const
     if (cpsr.t == 0)
         return pipe[1];
 
+    if (accuracy(state) != Accuracy::Accurate)
+        return pipe[1] << 16 | pipe[1];
+
     switch (Region(pc >> 24))
     {
     case Region::Bios:
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <shell/operators.h>
+
+template<typename Integral>
+SHELL_INLINE Integral Arm::fetch(u32 addr, Access access)
+{
+    u32 key = (addr & ~PageTable::kMask) | sizeof(Integral);
+
+    if (key != code_page.key)
+    {
+        const auto* page = pages.find(addr);
+        if (!page || !(page->flags & PageTable::Flag::Read))
+        {
+            if constexpr (sizeof(Integral) == 2)
+                return readHalf(addr, access);
+            else
+                return readWord(addr, access);
+        }
+
+        code_page.key  = key;
+        code_page.data = page->data;
+        code_page.rom  = page->flags & PageTable::Flag::Rom;
+        code_page.wait = page->wait[sizeof(Integral) == 4];
+    }
+
+    if (code_page.rom)
+        tickRom(addr, code_page.wait[uint(access)]);
+    else
+        tickRam(code_page.wait[uint(access)]);
+
+    return *reinterpret_cast<const Integral*>(code_page.data + (addr & PageTable::kMask & ~(sizeof(Integral) - 1)));
+}
+
+SHELL_INLINE u32* Arm::transferPage(u32 addr, uint count, bool write, u64& cycles)
+{
+    if (count == 0)
+        return nullptr;
+
+    const auto* page = pages.find(addr);
+    if (!page || !(page->flags & PageTable::Flag::Code))
+        return nullptr;
+
+    u32 offset = addr & PageTable::kMask & ~0x3;
+    if (offset + 4 * count > PageTable::kMask + 1)
+        return nullptr;
+
+    pipe.access = Access::NonSequential;
+
+    cycles = page->wait[1][0] + (count - 1) * page->wait[1][1];
+
+    if (write)
+    {
+        invalidate(addr);
+        invalidate(addr + 4 * (count - 1));
+    }
+    return reinterpret_cast<u32*>(page->data + offset);
+}
@@ -13,8 +13,8 @@ u8 Arm::readIo(u32 addr)
     {
     SHELL_CASE02(uint(Io::DisplayControl), return ppu.dispcnt.read(kIndex));
     SHELL_CASE02(uint(Io::GreenSwap),      return ppu.greenswap.read(kIndex));
-    SHELL_CASE02(uint(Io::DisplayStatus),  return ppu.dispstat.read(kIndex));
-    SHELL_CASE02(uint(Io::VerticalCount),  return ppu.vcount.read(kIndex));
+    SHELL_CASE02(uint(Io::DisplayStatus),  ppu.sync(); return ppu.dispstat.read(kIndex));
+    SHELL_CASE02(uint(Io::VerticalCount),  ppu.sync(); return ppu.vcount.read(kIndex));
     SHELL_CASE02(uint(Io::Bg0Control),     return ppu.backgrounds[0].control.read(kIndex));
     SHELL_CASE02(uint(Io::Bg1Control),     return ppu.backgrounds[1].control.read(kIndex));
     SHELL_CASE02(uint(Io::Bg2Control),     return ppu.backgrounds[2].control.read(kIndex));
@@ -39,13 +39,13 @@ u8 Arm::readIo(u32 addr)
     SHELL_CASE02(uint(Io::Dma2Control),    return dma.channels[2].control.read(kIndex));
     SHELL_CASE02(uint(Io::Dma3Count),      return 0);
     SHELL_CASE02(uint(Io::Dma3Control),    return dma.channels[3].control.read(kIndex));
-    SHELL_CASE02(uint(Io::Timer0Count),    return timer.channels[0].count.read(kIndex));
+    SHELL_CASE02(uint(Io::Timer0Count),    idle_loop = 0; return timer.channels[0].count.read(kIndex));
     SHELL_CASE02(uint(Io::Timer0Control),  return timer.channels[0].control.read(kIndex));
-    SHELL_CASE02(uint(Io::Timer1Count),    return timer.channels[1].count.read(kIndex));
+    SHELL_CASE02(uint(Io::Timer1Count),    idle_loop = 0; return timer.channels[1].count.read(kIndex));
     SHELL_CASE02(uint(Io::Timer1Control),  return timer.channels[1].control.read(kIndex));
-    SHELL_CASE02(uint(Io::Timer2Count),    return timer.channels[2].count.read(kIndex));
+    SHELL_CASE02(uint(Io::Timer2Count),    idle_loop = 0; return timer.channels[2].count.read(kIndex));
     SHELL_CASE02(uint(Io::Timer2Control),  return timer.channels[2].control.read(kIndex));
-    SHELL_CASE02(uint(Io::Timer3Count),    return timer.channels[3].count.read(kIndex));
+    SHELL_CASE02(uint(Io::Timer3Count),    idle_loop = 0; return timer.channels[3].count.read(kIndex));
     SHELL_CASE02(uint(Io::Timer3Control),  return timer.channels[3].control.read(kIndex));
     SHELL_CASE02(uint(Io::SioMulti),       return sio.siomulti.read(kIndex));
     SHELL_CASE02(uint(Io::SioControl),     return sio.siocnt.read(kIndex));
@@ -74,45 +74,15 @@ u8 Arm::readIo(u32 addr)
 
 void Arm::writeIo(u32 addr, u8 byte)
 {
+    if (addr < uint(Io::SoundSquare1) && (addr & ~0x1) != uint(Io::DisplayStatus))
+    {
+        ppu.writeIo(addr, byte);
+        return;
+    }
+
     switch (addr)
     {
-    SHELL_CASE02(uint(Io::DisplayControl), ppu.dispcnt.write(kIndex, byte));
-    SHELL_CASE02(uint(Io::GreenSwap),      ppu.greenswap.write(kIndex, byte));
-    SHELL_CASE02(uint(Io::DisplayStatus),  ppu.dispstat.write(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg0Control),     ppu.backgrounds[0].control.write(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg1Control),     ppu.backgrounds[1].control.write(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg2Control),     ppu.backgrounds[2].control.write(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg3Control),     ppu.backgrounds[3].control.write(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg0HorOffset),   ppu.backgrounds[0].offset.writeX(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg0VerOffset),   ppu.backgrounds[0].offset.writeY(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg1HorOffset),   ppu.backgrounds[1].offset.writeX(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg1VerOffset),   ppu.backgrounds[1].offset.writeY(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg2HorOffset),   ppu.backgrounds[2].offset.writeX(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg2VerOffset),   ppu.backgrounds[2].offset.writeY(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg3HorOffset),   ppu.backgrounds[3].offset.writeX(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg3VerOffset),   ppu.backgrounds[3].offset.writeY(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg2ParameterA),  ppu.backgrounds[2].matrix.writeA(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg2ParameterB),  ppu.backgrounds[2].matrix.writeB(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg2ParameterC),  ppu.backgrounds[2].matrix.writeC(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg2ParameterD),  ppu.backgrounds[2].matrix.writeD(kIndex, byte));
-    SHELL_CASE04(uint(Io::Bg2ReferenceX),  ppu.backgrounds[2].matrix.writeX(kIndex, byte));
-    SHELL_CASE04(uint(Io::Bg2ReferenceY),  ppu.backgrounds[2].matrix.writeY(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg3ParameterA),  ppu.backgrounds[3].matrix.writeA(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg3ParameterB),  ppu.backgrounds[3].matrix.writeB(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg3ParameterC),  ppu.backgrounds[3].matrix.writeC(kIndex, byte));
-    SHELL_CASE02(uint(Io::Bg3ParameterD),  ppu.backgrounds[3].matrix.writeD(kIndex, byte));
-    SHELL_CASE04(uint(Io::Bg3ReferenceX),  ppu.backgrounds[3].matrix.writeX(kIndex, byte));
-    SHELL_CASE04(uint(Io::Bg3ReferenceY),  ppu.backgrounds[3].matrix.writeY(kIndex, byte));
-    SHELL_CASE02(uint(Io::Window0Hor),     ppu.winh[0].write(kIndex, byte));
-    SHELL_CASE02(uint(Io::Window1Hor),     ppu.winh[1].write(kIndex, byte));
-    SHELL_CASE02(uint(Io::Window0Ver),     ppu.winv[0].write(kIndex, byte));
-    SHELL_CASE02(uint(Io::Window1Ver),     ppu.winv[1].write(kIndex, byte));
-    SHELL_CASE02(uint(Io::WindowInside),   ppu.winin.write(kIndex, byte));
-    SHELL_CASE02(uint(Io::WindowOutside),  ppu.winout.write(kIndex, byte));
-    SHELL_CASE02(uint(Io::Mosaic),         ppu.mosaic.write(kIndex, byte));
-    SHELL_CASE02(uint(Io::BlendControl),   ppu.bldcnt.write(kIndex, byte));
-    SHELL_CASE02(uint(Io::BlendAlpha),     ppu.bldalpha.write(kIndex, byte));
-    SHELL_CASE02(uint(Io::BlendFade),      ppu.bldfade.write(kIndex, byte));
+    SHELL_CASE02(uint(Io::DisplayStatus),  ppu.dispstat.write(kIndex, byte); ppu.schedule());
     SHELL_CASE08(uint(Io::SoundSquare1),   apu.square1.write(kIndex, byte));
     SHELL_CASE08(uint(Io::SoundSquare2),   apu.square2.write(kIndex, byte));
     SHELL_CASE08(uint(Io::SoundWave),      apu.wave.write(kIndex, byte));
@@ -157,7 +127,7 @@ void Arm::writeIo(u32 addr, u8 byte)
     SHELL_CASE02(uint(Io::JoyStatus),      sio.joystat.write(kIndex, byte));
     SHELL_CASE02(uint(Io::IrqEnable),      interrupt.enable.write(kIndex, byte));
     SHELL_CASE02(uint(Io::IrqRequest),     interrupt.request.write(kIndex, byte));
-    SHELL_CASE02(uint(Io::WaitControl),    waitcnt.write(kIndex, byte));
+    SHELL_CASE02(uint(Io::WaitControl),    waitcnt.write(kIndex, byte); pages.update(waitcnt); code_page = CodePage());
     SHELL_CASE04(uint(Io::IrqMaster),      interrupt.master.write(kIndex, byte));
     SHELL_CASE01(uint(Io::PostFlag),       postflg.write(kIndex, byte));
     SHELL_CASE01(uint(Io::HaltControl),    haltcnt.write(kIndex, byte));
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "base/int.h"
+
+#if defined(_WIN32)
+#define NATIVE_EXPORT extern "C" __declspec(dllexport)
+#else
+#define NATIVE_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+#define NATIVE_INIT "eggvance_native"
+
+struct NativeApi
+{
+    u32* regs;
+    u32* pipe;
+    const uint* state;
+    u32* zero;
+    u32* sign;
+    uint* carry;
+    uint* overflow;
+    void(*fetchArm)();
+    void(*fetchThumb)();
+    void(*executeArm)(u32 instr);
+    void(*executeThumb)(u32 instr);
+    void(*branchArm)(u32 addr);
+    void(*branchThumb)(u32 addr);
+    u32(*loadByte)(u32 addr);
+    u32(*loadHalf)(u32 addr);
+    u32(*loadWord)(u32 addr);
+    u32(*loadByteSignEx)(u32 addr);
+    u32(*loadHalfSignEx)(u32 addr);
+    void(*storeByte)(u32 addr, u32 value);
+    void(*storeHalf)(u32 addr, u32 value);
+    void(*storeWord)(u32 addr, u32 value);
+};
+
+struct NativeBlock
+{
+    u32 addr;
+    u32 size;
+    u32 thumb;
+    uint(*code)();
+};
+
+using NativeInit = const NativeBlock*(*)(const NativeApi* api, u64 hash, uint* count);
+
+// Flag helpers for generated code. They mirror Psr and shifts.inl, but
+// write resolved flags because native code runs with a resolved CPSR.
+
+inline bool nativeCheck(const NativeApi* api, uint condition)
+{
+    bool z = *api->zero == 0;
+    bool n = *api->sign >> 31;
+    bool c = *api->carry;
+    bool v = *api->overflow;
+
+    switch (condition)
+    {
+    case 0x0: return z;
+    case 0x1: return !z;
+    case 0x2: return c;
+    case 0x3: return !c;
+    case 0x4: return n;
+    case 0x5: return !n;
+    case 0x6: return v;
+    case 0x7: return !v;
+    case 0x8: return c && !z;
+    case 0x9: return !c || z;
+    case 0xA: return n == v;
+    case 0xB: return n != v;
+    case 0xC: return !z && n == v;
+    case 0xD: return z || n != v;
+    case 0xE: return true;
+
+    default:
+        return false;
+    }
+}
+
+inline u32 nativeLog(const NativeApi* api, u32 value)
+{
+    *api->zero = value;
+    *api->sign = value;
+    return value;
+}
+
+inline u32 nativeAdd(const NativeApi* api, u32 op1, u32 op2, uint carry)
+{
+    u32 res = op1 + op2 + carry;
+
+    *api->carry = (static_cast<u64>(op1) + op2 + carry) >> 32;
+    *api->overflow = ((op1 ^ res) & (~op1 ^ op2)) >> 31;
+    return nativeLog(api, res);
+}
+
+inline u32 nativeSub(const NativeApi* api, u32 op1, u32 op2, uint carry)
+{
+    u32 res = op1 - op2 - 1 + carry;
+
+    *api->carry = static_cast<u64>(op2) + 1 - carry <= op1;
+    *api->overflow = ((op1 ^ op2) & (~op2 ^ res)) >> 31;
+    return nativeLog(api, res);
+}
+
+inline u32 nativeShift(const NativeApi* api, uint type, u32 value, uint amount, bool flags)
+{
+    enum { kLsl, kLsr, kAsr, kRor };
+
+    uint carry = *api->carry;
+
+    switch (type)
+    {
+    case kLsl:
+        if (amount == 0)
+            return value;
+
+        carry = (value << (amount - 1)) >> 31;
+        value <<= amount;
+        break;
+
+    case kLsr:
+        carry = amount ? (value >> (amount - 1)) & 0x1 : value >> 31;
+        value = amount ? value >> amount : 0;
+        break;
+
+    case kAsr:
+        carry = amount ? (static_cast<s32>(value) >> (amount - 1)) & 0x1 : value >> 31;
+        value = static_cast<s32>(value) >> (amount ? amount : 31);
+        break;
+
+    case kRor:
+        if (amount == 0)
+        {
+            u32 rrx = (carry << 31) | (value >> 1);
+            carry = value & 0x1;
+            value = rrx;
+        }
+        else
+        {
+            value = (value >> amount) | (value << (32 - amount));
+            carry = value >> 31;
+        }
+        break;
+    }
+
+    if (flags)
+        *api->carry = carry;
+
+    return value;
+}
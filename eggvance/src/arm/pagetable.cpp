@@ -0,0 +1,27 @@
+#include "pagetable.h"
+
+#include <shell/operators.h>
+
+void PageTable::unmap(u32 addr, u32 size)
+{
+    for (u32 base = addr; base < addr + size; base += 1 << kBits)
+    {
+        pages[base >> kBits] = Page();
+    }
+}
+
+void PageTable::update(const WaitControl& waitcnt, u32 addr, u32 size)
+{
+    for (u32 base = addr; base < addr + size; base += 1 << kBits)
+    {
+        Page& page = pages[base >> kBits];
+        if (!(page.flags & Flag::Rom))
+            continue;
+
+        for (auto access : { Access::NonSequential, Access::Sequential })
+        {
+            page.wait[0][uint(access)] = static_cast<u8>(waitcnt.waitHalf(base, access));
+            page.wait[1][uint(access)] = static_cast<u8>(waitcnt.waitWord(base, access));
+        }
+    }
+}
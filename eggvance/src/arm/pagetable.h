@@ -0,0 +1,59 @@
+#pragma once
+
+#include <shell/array.h>
+#include <shell/macros.h>
+
+#include "io.h"
+#include "base/int.h"
+
+class PageTable
+{
+public:
+    static constexpr auto kBits = 14;
+    static constexpr auto kMask = (1 << kBits) - 1;
+    static constexpr auto kSize = 0x1000'0000 >> kBits;
+
+    enum class Flag
+    {
+        Read      = 1 << 0,
+        Write     = 1 << 1,
+        WriteByte = 1 << 2,
+        Rom       = 1 << 3,
+        Code      = 1 << 4
+    };
+
+    struct Page
+    {
+        u8* data = nullptr;
+        uint flags = 0;
+        shell::array<u8, 2, 2> wait = {};
+    };
+
+    SHELL_INLINE const Page* find(u32 addr) const
+    {
+        return addr < 0x1000'0000
+            ? &pages[addr >> kBits]
+            : nullptr;
+    }
+
+    template<typename Mirror>
+    void map(u32 addr, u32 size, u8* data, const Mirror& mirror, uint flags, u8 wait_half, u8 wait_word)
+    {
+        for (u32 base = addr; base < addr + size; base += 1 << kBits)
+        {
+            Page& page = pages[base >> kBits];
+            page.data  = data + mirror(base);
+            page.flags = flags;
+            page.wait[0][0] = wait_half;
+            page.wait[0][1] = wait_half;
+            page.wait[1][0] = wait_word;
+            page.wait[1][1] = wait_word;
+        }
+    }
+
+    void unmap(u32 addr, u32 size);
+    void update(const WaitControl& waitcnt, u32 addr = 0, u32 size = 0x1000'0000);
+
+private:
+    shell::array<Page, kSize> pages = {};
+};
@@ -0,0 +1,305 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <shell/format.h>
+
+#include "arm.h"
+#include "decode.h"
+
+static const char* name(u32 instr, bool thumb)
+{
+    static constexpr const char* kArm[] =
+    {
+        "Undefined",
+        "BranchExchange",
+        "BranchLink",
+        "DataProcessing",
+        "StatusTransfer",
+        "Multiply",
+        "MultiplyLong",
+        "SingleDataTransfer",
+        "HalfSignedDataTransfer",
+        "BlockDataTransfer",
+        "SingleDataSwap",
+        "SoftwareInterrupt",
+        "CoprocessorDataOperations",
+        "CoprocessorDataTransfers",
+        "CoprocessorRegisterTransfers"
+    };
+
+    static constexpr const char* kThumb[] =
+    {
+        "Undefined",
+        "MoveShiftedRegister",
+        "AddSubtract",
+        "ImmediateOperations",
+        "AluOperations",
+        "HighRegisterOperations",
+        "LoadPcRelative",
+        "LoadStoreRegisterOffset",
+        "LoadStoreByteHalf",
+        "LoadStoreImmediateOffset",
+        "LoadStoreHalf",
+        "LoadStoreSpRelative",
+        "LoadRelativeAddress",
+        "AddOffsetSp",
+        "PushPopRegisters",
+        "LoadStoreMultiple",
+        "ConditionalBranch",
+        "SoftwareInterrupt",
+        "UnconditionalBranch",
+        "LongBranchLink"
+    };
+
+    return thumb
+        ? kThumb[static_cast<uint>(decodeThumb(hashThumb(instr)))]
+        : kArm[static_cast<uint>(decodeArm(hashArm(instr)))];
+}
+
+bool Profiler::isActive() const
+{
+    return active;
+}
+
+void Profiler::start()
+{
+    active = true;
+    arm.state |= Arm::State::Profile;
+    arm.blocks_arm.clear();
+    arm.blocks_thumb.clear();
+}
+
+void Profiler::stop()
+{
+    active = false;
+    arm.state &= ~Arm::State::Profile;
+    arm.blocks_arm.clear();
+    arm.blocks_thumb.clear();
+}
+
+void Profiler::clear()
+{
+    block = 0;
+    expected = 0;
+    previous = 0;
+    node = 0;
+    frames.clear();
+    nodes = { Node() };
+    children.clear();
+    blocks.clear();
+    pcs.clear();
+    pairs[0].clear();
+    pairs[1].clear();
+}
+
+bool Profiler::loadSymbols(const fs::path& file)
+{
+    std::vector<u8> data;
+    if (fs::read(file, data) != fs::Status::Ok)
+        return false;
+
+    auto read = [&data](std::size_t offset, std::size_t size) -> u32
+    {
+        u32 value = 0;
+        for (std::size_t x = 0; x < size && offset + x < data.size(); ++x)
+            value |= data[offset + x] << (8 * x);
+
+        return value;
+    };
+
+    symbols.clear();
+
+    if (data.size() >= 0x34 && read(0, 4) == 0x464C'457F && data[4] == 1)
+    {
+        u32 shoff = read(0x20, 4);
+        u32 shentsize = read(0x2E, 2);
+        u32 shnum = read(0x30, 2);
+
+        for (u32 x = 0; x < shnum; ++x)
+        {
+            u32 section = shoff + x * shentsize;
+            if (read(section + 4, 4) != 2)
+                continue;
+
+            u32 offset  = read(section + 16, 4);
+            u32 size    = read(section + 20, 4);
+            u32 entsize = read(section + 36, 4);
+            u32 strings = read(shoff + read(section + 24, 4) * shentsize + 16, 4);
+
+            for (u32 entry = offset; entsize && entry + entsize <= offset + size; entry += entsize)
+            {
+                u32 name  = strings + read(entry + 0, 4);
+                u32 value = read(entry + 4, 4);
+                u32 type  = read(entry + 12, 1) & 0xF;
+                u32 index = read(entry + 14, 2);
+
+                if ((type != 0 && type != 2) || index == 0 || name >= data.size() || data[name] == 0 || data[name] == '$')
+                    continue;
+
+                const char* symbol = reinterpret_cast<const char*>(data.data() + name);
+
+                symbols[value & ~0x1] = std::string(symbol, strnlen(symbol, data.size() - name));
+            }
+        }
+    }
+    else
+    {
+        std::istringstream stream(std::string(data.begin(), data.end()));
+
+        std::string line;
+        while (std::getline(stream, line))
+        {
+            std::istringstream tokens(line);
+
+            u32 addr;
+            std::string symbol;
+            if (!(tokens >> std::hex >> addr >> symbol) || symbol.front() == '.')
+                continue;
+
+            symbols[addr & ~0x1] = symbol;
+        }
+    }
+    return !symbols.empty();
+}
+
+bool Profiler::writeFolded(const fs::path& file) const
+{
+    std::string data;
+    for (const auto& [key, sample] : blocks)
+    {
+        if (sample.cycles == 0)
+            continue;
+
+        data += shell::format("{}{} {}\n",
+            stack(static_cast<uint>(key >> 32)),
+            symbol(static_cast<u32>(key)),
+            sample.cycles);
+    }
+    return fs::write(file, data) == fs::Status::Ok;
+}
+
+bool Profiler::writeFlat(const fs::path& file) const
+{
+    std::vector<std::pair<u32, Sample>> sorted(pcs.begin(), pcs.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b)
+    {
+        return a.second.cycles > b.second.cycles;
+    });
+
+    std::string data = "address   cycles          instructions    symbol\n";
+    for (const auto& [addr, sample] : sorted)
+    {
+        data += shell::format("{:08X}  {:<14}  {:<14}  {}\n",
+            addr, sample.cycles, sample.instructions, symbol(addr));
+    }
+    return fs::write(file, data) == fs::Status::Ok;
+}
+
+bool Profiler::writePairs(const fs::path& file) const
+{
+    std::map<std::string, u64> classes;
+    for (uint thumb = 0; thumb < 2; ++thumb)
+    {
+        for (const auto& [key, count] : pairs[thumb])
+        {
+            classes[shell::format("{} {} -> {}",
+                thumb ? "Thumb" : "Arm",
+                name(static_cast<u32>(key >> 32), thumb),
+                name(static_cast<u32>(key), thumb))] += count;
+        }
+    }
+
+    std::vector<std::pair<std::string, u64>> sorted(classes.begin(), classes.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b)
+    {
+        return a.second > b.second;
+    });
+
+    std::string data = "count           pair\n";
+    for (const auto& [pair, count] : sorted)
+        data += shell::format("{:<14}  {}\n", count, pair);
+
+    return fs::write(file, data) == fs::Status::Ok;
+}
+
+void Profiler::halt(u64 cycles)
+{
+    record(kHalt, cycles, 0);
+}
+
+void Profiler::dma(u64 cycles)
+{
+    record(kDma, cycles, 0);
+}
+
+void Profiler::interrupt(u32 addr)
+{
+    call(0x18, addr);
+}
+
+void Profiler::branch(u32 ret, u32 next, u32 lr)
+{
+    for (uint x = frames.size(); x--; )
+    {
+        if (frames[x].ret == next)
+        {
+            node = x ? frames[x - 1].node : 0;
+            frames.resize(x);
+            return;
+        }
+    }
+
+    if ((lr & ~0x1) == ret)
+        call(next, ret);
+}
+
+void Profiler::call(u32 function, u32 ret)
+{
+    if (frames.size() >= kMaxDepth)
+        return;
+
+    u64 key = static_cast<u64>(node) << 32 | function;
+
+    auto iter = children.find(key);
+    if ( iter == children.end())
+    {
+        iter = children.emplace(key, static_cast<uint>(nodes.size())).first;
+        nodes.push_back({ node, function });
+    }
+
+    node = iter->second;
+    frames.push_back({ ret, node });
+}
+
+std::string Profiler::symbol(u32 addr) const
+{
+    switch (addr)
+    {
+    case kHalt: return "[halt]";
+    case kDma:  return "[dma]";
+    }
+
+    auto iter = symbols.upper_bound(addr);
+    if ( iter == symbols.begin())
+        return shell::format("{:08X}", addr);
+
+    --iter;
+    if (iter->first >> 24 != addr >> 24)
+        return shell::format("{:08X}", addr);
+
+    if (addr == iter->first)
+        return iter->second;
+
+    return shell::format("{}+0x{:X}", iter->second, addr - iter->first);
+}
+
+std::string Profiler::stack(uint node) const
+{
+    std::string result;
+    for (; node; node = nodes[node].parent)
+        result = symbol(nodes[node].function) + ";" + result;
+
+    return result;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <shell/macros.h>
+
+#include "base/filesystem.h"
+#include "base/int.h"
+
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 0
+#endif
+
+class Profiler
+{
+public:
+    bool isActive() const;
+
+    void start();
+    void stop();
+    void clear();
+
+    bool loadSymbols(const fs::path& file);
+    bool writeFolded(const fs::path& file) const;
+    bool writeFlat(const fs::path& file) const;
+    bool writePairs(const fs::path& file) const;
+
+    void halt(u64 cycles);
+    void dma(u64 cycles);
+    void interrupt(u32 addr);
+
+    SHELL_INLINE void sample(u32 addr, u32 instr, u32 next, u32 lr, uint size, u64 cycles)
+    {
+        if (addr != expected)
+            block = addr;
+        else
+            pairs[size == 2][static_cast<u64>(previous) << 32 | instr]++;
+
+        previous = instr;
+
+        record(block, cycles, 1);
+        pcs[addr].add(cycles, 1);
+
+        expected = next;
+
+        if (next != addr + size)
+            branch(addr + size, next, lr);
+    }
+
+private:
+    static constexpr auto kMaxDepth = 256;
+    static constexpr u32 kHalt = 0xFFFF'FFFF;
+    static constexpr u32 kDma  = 0xFFFF'FFFE;
+
+    struct Sample
+    {
+        void add(u64 cycles, u64 instructions)
+        {
+            this->cycles += cycles;
+            this->instructions += instructions;
+        }
+
+        u64 cycles = 0;
+        u64 instructions = 0;
+    };
+
+    struct Frame
+    {
+        u32 ret = 0;
+        uint node = 0;
+    };
+
+    struct Node
+    {
+        uint parent = 0;
+        u32 function = 0;
+    };
+
+    SHELL_INLINE void record(u32 addr, u64 cycles, u64 instructions)
+    {
+        blocks[static_cast<u64>(node) << 32 | addr].add(cycles, instructions);
+    }
+
+    void branch(u32 ret, u32 next, u32 lr);
+    void call(u32 function, u32 ret);
+    std::string symbol(u32 addr) const;
+    std::string stack(uint node) const;
+
+    bool active = false;
+    u32 block = 0;
+    u32 expected = 0;
+    u32 previous = 0;
+    uint node = 0;
+    std::vector<Frame> frames;
+    std::vector<Node> nodes = { Node() };
+    std::unordered_map<u64, uint> children;
+    std::unordered_map<u64, Sample> blocks;
+    std::unordered_map<u32, Sample> pcs;
+    std::unordered_map<u64, u64> pairs[2];
+    std::map<u32, std::string> symbols;
+};
+
+inline Profiler profiler;
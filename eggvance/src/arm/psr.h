@@ -7,7 +7,7 @@
 class Psr
 {
 public:
-    enum class Mode
+    enum class Mode : u8
     {
         Usr = 0b10000,
         Fiq = 0b10001,
@@ -18,16 +18,100 @@ class Psr
         Und = 0b11011
     };
 
+    enum class Lazy : u8 { None, Add, Sub };
+
     Psr& operator=(u32 value);
     operator u32() const;
 
     uint size() const;
-    void setZ(u32 value);
-    void setN(u32 value);
-    void setCAdd(u64 op1, u64 op2);
-    void setCSub(u64 op1, u64 op2);
-    void setVAdd(u32 op1, u32 op2, u32 res);
-    void setVSub(u32 op1, u32 op2, u32 res);
+
+    SHELL_INLINE uint z() const
+    {
+        return zero == 0;
+    }
+
+    SHELL_INLINE uint n() const
+    {
+        return sign >> 31;
+    }
+
+    SHELL_INLINE uint c() const
+    {
+        switch (lazy)
+        {
+        case Lazy::Add: return (static_cast<u64>(op1) + op2 + carry_in) >> 32;
+        case Lazy::Sub: return static_cast<u64>(op2) + 1 - carry_in <= op1;
+
+        default:
+            return carry;
+        }
+    }
+
+    SHELL_INLINE uint v() const
+    {
+        switch (lazy)
+        {
+        case Lazy::Add: return ((op1 ^ result()) & (~op1 ^ op2)) >> 31;
+        case Lazy::Sub: return ((op1 ^ op2) & (~op2 ^ result())) >> 31;
+
+        default:
+            return overflow;
+        }
+    }
+
+    SHELL_INLINE void setNZ(u32 value)
+    {
+        zero = value;
+        sign = value;
+    }
+
+    SHELL_INLINE void setZ(uint value)
+    {
+        zero = !value;
+    }
+
+    SHELL_INLINE void setN(uint value)
+    {
+        sign = value << 31;
+    }
+
+    SHELL_INLINE void setC(uint value)
+    {
+        resolve();
+        carry = value;
+    }
+
+    SHELL_INLINE void setV(uint value)
+    {
+        resolve();
+        overflow = value;
+    }
+
+    SHELL_INLINE void setAdd(u32 op1, u32 op2, uint carry_in)
+    {
+        this->lazy = Lazy::Add;
+        this->op1  = op1;
+        this->op2  = op2;
+        this->carry_in = carry_in;
+    }
+
+    SHELL_INLINE void setSub(u32 op1, u32 op2, uint carry_in)
+    {
+        this->lazy = Lazy::Sub;
+        this->op1  = op1;
+        this->op2  = op2;
+        this->carry_in = carry_in;
+    }
+
+    SHELL_INLINE void resolve()
+    {
+        if (lazy != Lazy::None)
+        {
+            carry    = c();
+            overflow = v();
+            lazy     = Lazy::None;
+        }
+    }
 
     SHELL_INLINE bool check(uint condition) const
     {
@@ -41,20 +125,20 @@ class Psr
 
         switch (Condition(condition))
         {
-        case Condition::EQ: return z;
-        case Condition::NE: return !z;
-        case Condition::CS: return c;
-        case Condition::CC: return !c;
-        case Condition::MI: return n;
-        case Condition::PL: return !n;
-        case Condition::VS: return v;
-        case Condition::VC: return !v;
-        case Condition::HI: return c && !z;
-        case Condition::LS: return !c || z;
-        case Condition::GE: return n == v;
-        case Condition::LT: return n != v;
-        case Condition::GT: return !z && (n == v);
-        case Condition::LE: return z || (n != v);
+        case Condition::EQ: return z();
+        case Condition::NE: return !z();
+        case Condition::CS: return c();
+        case Condition::CC: return !c();
+        case Condition::MI: return n();
+        case Condition::PL: return !n();
+        case Condition::VS: return v();
+        case Condition::VC: return !v();
+        case Condition::HI: return c() && !z();
+        case Condition::LS: return !c() || z();
+        case Condition::GE: return n() == v();
+        case Condition::LT: return n() != v();
+        case Condition::GT: return !z() && (n() == v());
+        case Condition::LE: return z() || (n() != v());
         case Condition::AL: return true;
         case Condition::NV: return false;
 
@@ -64,12 +148,26 @@ class Psr
         }
     }
 
+    u32 zero = 1;
+    u32 sign = 0;
+    uint carry = 0;
+    uint overflow = 0;
+    u32 op1 = 0;
+    u32 op2 = 0;
+    uint carry_in = 0;
+    Lazy lazy = Lazy::None;
     Mode m = Mode::Svc;
-    uint t = 0;
-    uint f = 0;
-    uint i = 0;
-    uint v = 0;
-    uint c = 0;
-    uint z = 0;
-    uint n = 0;
+    u8 t = 0;
+    u8 f = 0;
+    u8 i = 0;
+
+private:
+    SHELL_INLINE u32 result() const
+    {
+        return lazy == Lazy::Add
+            ? op1 + op2 + carry_in
+            : op1 - op2 - 1 + carry_in;
+    }
 };
+
+static_assert(sizeof(Psr) == 36);
@@ -0,0 +1,905 @@
+#include "recompiler.h"
+
+#include <set>
+#include <vector>
+#include <shell/format.h>
+#include <shell/predef.h>
+
+#if SHELL_OS_WINDOWS
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#include "arm.h"
+#include "decode.h"
+#include "base/config.h"
+#include "gamepak/gamepak.h"
+
+#if SHELL_OS_WINDOWS
+static constexpr auto kExtension = ".dll";
+#else
+static constexpr auto kExtension = ".so";
+#endif
+
+static bool isRom(u32 addr, uint size)
+{
+    return addr >= 0x0800'0000 && addr < 0x0A00'0000 && (addr & 0x1FF'FFFF) + size <= gamepak.rom.size();
+}
+
+template<typename Integral>
+static Integral readRom(u32 addr)
+{
+    return gamepak.rom.read<Integral>(addr & 0x1FF'FFFF);
+}
+
+template<typename Integral>
+struct Trace
+{
+    u32 addr = 0;
+    std::vector<Integral> instrs;
+};
+
+static u32 key(u32 addr, bool thumb)
+{
+    return addr | thumb;
+}
+
+static bool constant(u16 instr, u32 addr, uint& rd, u32& value)
+{
+    rd = bit::seq<8, 3>(instr);
+
+    switch (decodeThumb(hashThumb(instr)))
+    {
+    case InstructionThumb::LoadPcRelative:
+        addr = ((addr + 4) & ~0x3) + 4 * bit::seq<0, 8>(instr);
+        if (!isRom(addr, 4))
+            return false;
+
+        value = readRom<u32>(addr);
+        return true;
+
+    case InstructionThumb::LoadRelativeAddress:
+        value = ((addr + 4) & ~0x3) + 4 * bit::seq<0, 8>(instr);
+        return !bit::seq<11, 1>(instr);
+
+    default:
+        return false;
+    }
+}
+
+static bool constant(u32 instr, u32 addr, uint& rd, u32& value)
+{
+    rd = bit::seq<12, 4>(instr);
+
+    if (bit::seq<28, 4>(instr) != 0xE)
+        return false;
+
+    switch (decodeArm(hashArm(instr)))
+    {
+    case InstructionArm::SingleDataTransfer:
+        if ((instr & 0x0F7F'0000) != 0x051F'0000)
+            return false;
+
+        addr = bit::seq<23, 1>(instr)
+            ? addr + 8 + bit::seq<0, 12>(instr)
+            : addr + 8 - bit::seq<0, 12>(instr);
+
+        if (!isRom(addr, 4))
+            return false;
+
+        value = readRom<u32>(addr);
+        return true;
+
+    case InstructionArm::DataProcessing:
+        if ((instr & 0x0FFF'0000) != 0x028F'0000)
+            return false;
+
+        value = addr + 8 + bit::ror(bit::seq<0, 8>(instr), 2 * bit::seq<8, 4>(instr));
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+static void targets(const Trace<u16>& block, std::vector<u32>& work)
+{
+    bool known = false;
+    uint known_rd = 0;
+    u32 known_value = 0;
+
+    for (uint x = 0; x < block.instrs.size(); ++x)
+    {
+        u16 instr = block.instrs[x];
+        u32 addr  = block.addr + 2 * x;
+
+        uint rd = 0;
+        u32 value = 0;
+        bool loads = constant(instr, addr, rd, value);
+
+        switch (decodeThumb(hashThumb(instr)))
+        {
+        case InstructionThumb::ConditionalBranch:
+            work.push_back(key(addr + 4 + (bit::signEx<8>(static_cast<u32>(bit::seq<0, 8>(instr))) << 1), true));
+            work.push_back(key(addr + 2, true));
+            break;
+
+        case InstructionThumb::UnconditionalBranch:
+            work.push_back(key(addr + 4 + (bit::signEx<11>(static_cast<u32>(bit::seq<0, 11>(instr))) << 1), true));
+            break;
+
+        case InstructionThumb::SoftwareInterrupt:
+            work.push_back(key(addr + 2, true));
+            break;
+
+        case InstructionThumb::LongBranchLink:
+            if (!bit::seq<11, 1>(instr) && x + 1 < block.instrs.size())
+            {
+                u32 offset = bit::signEx<11>(static_cast<u32>(bit::seq<0, 11>(instr))) << 12;
+
+                work.push_back(key(addr + 4 + offset + (bit::seq<0, 11>(block.instrs[x + 1]) << 1), true));
+                work.push_back(key(addr + 4, true));
+            }
+            break;
+
+        case InstructionThumb::HighRegisterOperations:
+            if (bit::seq<8, 2>(instr) == 3 && known && known_rd == bit::seq<3, 4>(instr))
+                work.push_back(key(known_value & ~0x1, known_value & 0x1));
+            break;
+
+        default:
+            break;
+        }
+
+        known = loads;
+        known_rd = rd;
+        known_value = value;
+    }
+
+    if (!isTerminal(block.instrs.back()))
+        work.push_back(key(block.addr + 2 * block.instrs.size(), true));
+}
+
+static void targets(const Trace<u32>& block, std::vector<u32>& work)
+{
+    bool known = false;
+    uint known_rd = 0;
+    u32 known_value = 0;
+
+    for (uint x = 0; x < block.instrs.size(); ++x)
+    {
+        u32 instr = block.instrs[x];
+        u32 addr  = block.addr + 4 * x;
+
+        uint rd = 0;
+        u32 value = 0;
+        bool loads = constant(instr, addr, rd, value);
+
+        bool always = bit::seq<28, 4>(instr) == 0xE;
+
+        switch (decodeArm(hashArm(instr)))
+        {
+        case InstructionArm::BranchLink:
+            work.push_back(key(addr + 8 + (bit::signEx<24>(bit::seq<0, 24>(instr)) << 2), false));
+            if (!always || bit::seq<24, 1>(instr))
+                work.push_back(key(addr + 4, false));
+            break;
+
+        case InstructionArm::BranchExchange:
+            if (known && known_rd == bit::seq<0, 4>(instr))
+                work.push_back(key(known_value & ~(known_value & 0x1 ? 0x1 : 0x3), known_value & 0x1));
+            if (!always)
+                work.push_back(key(addr + 4, false));
+            break;
+
+        case InstructionArm::SoftwareInterrupt:
+            work.push_back(key(addr + 4, false));
+            break;
+
+        default:
+            if (isTerminal(instr) && !always)
+                work.push_back(key(addr + 4, false));
+            break;
+        }
+
+        if (!loads && known && instr == 0xE1A0'E00F)
+            continue;
+
+        known = loads;
+        known_rd = rd;
+        known_value = value;
+    }
+
+    if (!isTerminal(block.instrs.back()))
+        work.push_back(key(block.addr + 4 * block.instrs.size(), false));
+}
+
+template<typename Integral>
+static bool discover(u32 addr, uint limit, Trace<Integral>& block)
+{
+    constexpr uint kSize = sizeof(Integral);
+
+    block.addr = addr;
+
+    for (u32 next = addr; block.instrs.size() < limit; next += kSize)
+    {
+        if ((next + 2 * kSize) >> 24 != addr >> 24 || !isRom(next, 3 * kSize))
+            break;
+
+        Integral instr = readRom<Integral>(next);
+
+        block.instrs.push_back(instr);
+
+        if (isTerminal(instr))
+            break;
+    }
+    return !block.instrs.empty();
+}
+
+static std::string reg(uint index, u32 pc)
+{
+    return index == 15
+        ? shell::format("0x{:08X}", pc)
+        : shell::format("r[{}]", index);
+}
+
+static std::string translate(u16 instr, u32 addr, uint count)
+{
+    switch (decodeThumb(hashThumb(instr)))
+    {
+    case InstructionThumb::MoveShiftedRegister:
+        return shell::format("    r[{}] = nativeLog(api, nativeShift(api, {}, r[{}], {}, true));\n",
+            bit::seq<0, 3>(instr), bit::seq<11, 2>(instr), bit::seq<3, 3>(instr), bit::seq<6, 5>(instr));
+
+    case InstructionThumb::AddSubtract:
+    {
+        enum class Opcode { AddReg, SubReg, AddImm, SubImm };
+
+        uint rd = bit::seq<0, 3>(instr);
+        uint rs = bit::seq<3, 3>(instr);
+        uint rn = bit::seq<6, 3>(instr);
+
+        switch (Opcode(bit::seq<9, 2>(instr)))
+        {
+        case Opcode::AddReg: return shell::format("    r[{}] = nativeAdd(api, r[{}], r[{}], 0);\n", rd, rs, rn);
+        case Opcode::SubReg: return shell::format("    r[{}] = nativeSub(api, r[{}], r[{}], 1);\n", rd, rs, rn);
+        case Opcode::AddImm: return shell::format("    r[{}] = nativeAdd(api, r[{}], {}, 0);\n", rd, rs, rn);
+        case Opcode::SubImm: return shell::format("    r[{}] = nativeSub(api, r[{}], {}, 1);\n", rd, rs, rn);
+        }
+        break;
+    }
+
+    case InstructionThumb::ImmediateOperations:
+    {
+        enum class Opcode { Mov, Cmp, Add, Sub };
+
+        uint rd  = bit::seq<8, 3>(instr);
+        uint imm = bit::seq<0, 8>(instr);
+
+        switch (Opcode(bit::seq<11, 2>(instr)))
+        {
+        case Opcode::Mov: return shell::format("    r[{}] = nativeLog(api, 0x{:X});\n", rd, imm);
+        case Opcode::Cmp: return shell::format("    nativeSub(api, r[{}], 0x{:X}, 1);\n", rd, imm);
+        case Opcode::Add: return shell::format("    r[{0}] = nativeAdd(api, r[{0}], 0x{1:X}, 0);\n", rd, imm);
+        case Opcode::Sub: return shell::format("    r[{0}] = nativeSub(api, r[{0}], 0x{1:X}, 1);\n", rd, imm);
+        }
+        break;
+    }
+
+    case InstructionThumb::AluOperations:
+    {
+        enum class Opcode
+        {
+            And, Eor, Lsl, Lsr,
+            Asr, Adc, Sbc, Ror,
+            Tst, Neg, Cmp, Cmn,
+            Orr, Mul, Bic, Mvn
+        };
+
+        uint rd = bit::seq<0, 3>(instr);
+        uint rs = bit::seq<3, 3>(instr);
+
+        switch (Opcode(bit::seq<6, 4>(instr)))
+        {
+        case Opcode::And: return shell::format("    r[{0}] = nativeLog(api, r[{0}] & r[{1}]);\n", rd, rs);
+        case Opcode::Eor: return shell::format("    r[{0}] = nativeLog(api, r[{0}] ^ r[{1}]);\n", rd, rs);
+        case Opcode::Orr: return shell::format("    r[{0}] = nativeLog(api, r[{0}] | r[{1}]);\n", rd, rs);
+        case Opcode::Bic: return shell::format("    r[{0}] = nativeLog(api, r[{0}] & ~r[{1}]);\n", rd, rs);
+        case Opcode::Mvn: return shell::format("    r[{0}] = nativeLog(api, ~r[{1}]);\n", rd, rs);
+        case Opcode::Tst: return shell::format("    nativeLog(api, r[{0}] & r[{1}]);\n", rd, rs);
+        case Opcode::Cmn: return shell::format("    nativeAdd(api, r[{0}], r[{1}], 0);\n", rd, rs);
+        case Opcode::Cmp: return shell::format("    nativeSub(api, r[{0}], r[{1}], 1);\n", rd, rs);
+        case Opcode::Adc: return shell::format("    r[{0}] = nativeAdd(api, r[{0}], r[{1}], *api->carry);\n", rd, rs);
+        case Opcode::Sbc: return shell::format("    r[{0}] = nativeSub(api, r[{0}], r[{1}], *api->carry);\n", rd, rs);
+        case Opcode::Neg: return shell::format("    r[{0}] = nativeSub(api, 0, r[{1}], 1);\n", rd, rs);
+
+        default:
+            break;
+        }
+        break;
+    }
+
+    case InstructionThumb::HighRegisterOperations:
+    {
+        enum class Opcode { Add, Cmp, Mov, Bx };
+
+        uint rd = bit::seq<0, 3>(instr) | bit::seq<7, 1>(instr) << 3;
+        uint rs = bit::seq<3, 3>(instr) | bit::seq<6, 1>(instr) << 3;
+
+        switch (Opcode(bit::seq<8, 2>(instr)))
+        {
+        case Opcode::Add:
+            if (rd == 15)
+                break;
+            return shell::format("    r[{}] += {};\n", rd, reg(rs, addr + 4));
+
+        case Opcode::Mov:
+            if (rd == 15)
+                break;
+            return shell::format("    r[{}] = {};\n", rd, reg(rs, addr + 4));
+
+        case Opcode::Cmp:
+            return shell::format("    nativeSub(api, {}, {}, 1);\n", reg(rd, addr + 4), reg(rs, addr + 4));
+
+        default:
+            break;
+        }
+        break;
+    }
+
+    case InstructionThumb::LoadPcRelative:
+        return shell::format("    r[{}] = api->loadWord(0x{:08X});\n", bit::seq<8, 3>(instr), ((addr + 4) & ~0x3) + 4 * bit::seq<0, 8>(instr));
+
+    case InstructionThumb::LoadStoreRegisterOffset:
+    {
+        static constexpr const char* kFormats[] =
+        {
+            "    api->storeWord(r[{1}] + r[{2}], r[{0}]);\n",
+            "    api->storeByte(r[{1}] + r[{2}], r[{0}]);\n",
+            "    r[{0}] = api->loadWord(r[{1}] + r[{2}]);\n",
+            "    r[{0}] = api->loadByte(r[{1}] + r[{2}]);\n"
+        };
+        return shell::format(kFormats[bit::seq<10, 2>(instr)], bit::seq<0, 3>(instr), bit::seq<3, 3>(instr), bit::seq<6, 3>(instr));
+    }
+
+    case InstructionThumb::LoadStoreByteHalf:
+    {
+        static constexpr const char* kFormats[] =
+        {
+            "    api->storeHalf(r[{1}] + r[{2}], r[{0}]);\n",
+            "    r[{0}] = api->loadByteSignEx(r[{1}] + r[{2}]);\n",
+            "    r[{0}] = api->loadHalf(r[{1}] + r[{2}]);\n",
+            "    r[{0}] = api->loadHalfSignEx(r[{1}] + r[{2}]);\n"
+        };
+        return shell::format(kFormats[bit::seq<10, 2>(instr)], bit::seq<0, 3>(instr), bit::seq<3, 3>(instr), bit::seq<6, 3>(instr));
+    }
+
+    case InstructionThumb::LoadStoreImmediateOffset:
+    {
+        static constexpr const char* kFormats[] =
+        {
+            "    api->storeWord(r[{1}] + 0x{2:X}, r[{0}]);\n",
+            "    r[{0}] = api->loadWord(r[{1}] + 0x{2:X});\n",
+            "    api->storeByte(r[{1}] + 0x{2:X}, r[{0}]);\n",
+            "    r[{0}] = api->loadByte(r[{1}] + 0x{2:X});\n"
+        };
+        uint opcode = bit::seq<11, 2>(instr);
+        return shell::format(kFormats[opcode], bit::seq<0, 3>(instr), bit::seq<3, 3>(instr), bit::seq<6, 5>(instr) << (~opcode & 0x2));
+    }
+
+    case InstructionThumb::LoadStoreHalf:
+        return shell::format(bit::seq<11, 1>(instr)
+                ? "    r[{0}] = api->loadHalf(r[{1}] + 0x{2:X});\n"
+                : "    api->storeHalf(r[{1}] + 0x{2:X}, r[{0}]);\n",
+            bit::seq<0, 3>(instr), bit::seq<3, 3>(instr), bit::seq<6, 5>(instr) << 1);
+
+    case InstructionThumb::LoadStoreSpRelative:
+        return shell::format(bit::seq<11, 1>(instr)
+                ? "    r[{0}] = api->loadWord(r[13] + 0x{1:X});\n"
+                : "    api->storeWord(r[13] + 0x{1:X}, r[{0}]);\n",
+            bit::seq<8, 3>(instr), bit::seq<0, 8>(instr) << 2);
+
+    case InstructionThumb::LoadRelativeAddress:
+        if (bit::seq<11, 1>(instr))
+            return shell::format("    r[{}] = r[13] + 0x{:X};\n", bit::seq<8, 3>(instr), 4 * bit::seq<0, 8>(instr));
+        else
+            return shell::format("    r[{}] = 0x{:08X};\n", bit::seq<8, 3>(instr), ((addr + 4) & ~0x3) + 4 * bit::seq<0, 8>(instr));
+
+    case InstructionThumb::AddOffsetSp:
+        return shell::format("    r[13] {}= 0x{:X};\n", bit::seq<7, 1>(instr) ? '-' : '+', 4 * bit::seq<0, 7>(instr));
+
+    case InstructionThumb::ConditionalBranch:
+        return shell::format("    if (nativeCheck(api, 0x{:X}))\n    {{\n        api->branchThumb(0x{:08X});\n        return {};\n    }}\n",
+            bit::seq<8, 4>(instr), addr + 4 + (bit::signEx<8>(static_cast<u32>(bit::seq<0, 8>(instr))) << 1), count);
+
+    case InstructionThumb::UnconditionalBranch:
+        return shell::format("    api->branchThumb(0x{:08X});\n    return {};\n",
+            addr + 4 + (bit::signEx<11>(static_cast<u32>(bit::seq<0, 11>(instr))) << 1), count);
+
+    case InstructionThumb::LongBranchLink:
+        if (bit::seq<11, 1>(instr))
+            return shell::format("    {{\n        u32 target = r[14] + 0x{:X};\n        r[14] = 0x{:08X};\n        api->branchThumb(target);\n        return {};\n    }}\n",
+                bit::seq<0, 11>(instr) << 1, (addr + 2) | 0x1, count);
+        else
+            return shell::format("    r[14] = 0x{:08X};\n", addr + 4 + (bit::signEx<11>(static_cast<u32>(bit::seq<0, 11>(instr))) << 12));
+
+    default:
+        break;
+    }
+    return std::string();
+}
+
+static std::string translateDataProcessing(u32 instr, u32 addr)
+{
+    enum class Opcode
+    {
+        And, Eor, Sub, Rsb,
+        Add, Adc, Sbc, Rsc,
+        Tst, Teq, Cmp, Cmn,
+        Orr, Mov, Bic, Mvn
+    };
+
+    uint flags  = bit::seq<20, 1>(instr);
+    uint opcode = bit::seq<21, 4>(instr);
+    uint rd     = bit::seq<12, 4>(instr);
+
+    if (rd == 15 || (!bit::seq<25, 1>(instr) && bit::seq<4, 1>(instr)))
+        return std::string();
+
+    bool logical = opcode <= 1 || (opcode >= 8 && opcode <= 9) || opcode >= 12;
+
+    std::string code;
+    std::string op1 = reg(bit::seq<16, 4>(instr), addr + 8);
+    std::string op2;
+
+    if (bit::seq<25, 1>(instr))
+    {
+        uint rotate = 2 * bit::seq<8, 4>(instr);
+        u32  value  = bit::ror(bit::seq<0, 8>(instr), rotate);
+
+        if (flags && logical && rotate)
+            code += shell::format("    *api->carry = {};\n", value >> 31);
+
+        op2 = shell::format("0x{:X}", value);
+    }
+    else
+    {
+        uint shift  = bit::seq<5, 2>(instr);
+        uint amount = bit::seq<7, 5>(instr);
+
+        op2 = reg(bit::seq<0, 4>(instr), addr + 8);
+
+        if (shift != 0 || amount != 0)
+            op2 = shell::format("nativeShift(api, {}, {}, {}, {})", shift, op2, amount, flags && logical ? "true" : "false");
+    }
+
+    std::string expr;
+    switch (Opcode(opcode))
+    {
+    case Opcode::And: expr = shell::format("{} & {}", op1, op2); break;
+    case Opcode::Eor: expr = shell::format("{} ^ {}", op1, op2); break;
+    case Opcode::Orr: expr = shell::format("{} | {}", op1, op2); break;
+    case Opcode::Mov: expr = op2; break;
+    case Opcode::Bic: expr = shell::format("{} & ~{}", op1, op2); break;
+    case Opcode::Mvn: expr = shell::format("~{}", op2); break;
+    case Opcode::Tst: return code + shell::format("    nativeLog(api, {} & {});\n", op1, op2);
+    case Opcode::Teq: return code + shell::format("    nativeLog(api, {} ^ {});\n", op1, op2);
+    case Opcode::Cmn: return code + shell::format("    nativeAdd(api, {}, {}, 0);\n", op1, op2);
+    case Opcode::Cmp: return code + shell::format("    nativeSub(api, {}, {}, 1);\n", op1, op2);
+    case Opcode::Add: expr = shell::format(flags ? "nativeAdd(api, {}, {}, 0)" : "{} + {}", op1, op2); break;
+    case Opcode::Adc: expr = shell::format(flags ? "nativeAdd(api, {}, {}, *api->carry)" : "{} + {} + *api->carry", op1, op2); break;
+    case Opcode::Sub: expr = shell::format(flags ? "nativeSub(api, {}, {}, 1)" : "{} - {}", op1, op2); break;
+    case Opcode::Sbc: expr = shell::format(flags ? "nativeSub(api, {}, {}, *api->carry)" : "{} - {} - 1 + *api->carry", op1, op2); break;
+    case Opcode::Rsb: expr = shell::format(flags ? "nativeSub(api, {}, {}, 1)" : "{} - {}", op2, op1); break;
+    case Opcode::Rsc: expr = shell::format(flags ? "nativeSub(api, {}, {}, *api->carry)" : "{} - {} - 1 + *api->carry", op2, op1); break;
+    }
+
+    if (flags && logical)
+        expr = shell::format("nativeLog(api, {})", expr);
+
+    return code + shell::format("    r[{}] = {};\n", rd, expr);
+}
+
+static std::string translateSingleDataTransfer(u32 instr, u32 addr)
+{
+    uint load      = bit::seq<20, 1>(instr);
+    uint writeback = bit::seq<21, 1>(instr);
+    uint byte      = bit::seq<22, 1>(instr);
+    uint increment = bit::seq<23, 1>(instr);
+    uint pre_index = bit::seq<24, 1>(instr);
+    uint reg_op    = bit::seq<25, 1>(instr);
+
+    uint rd = bit::seq<12, 4>(instr);
+    uint rn = bit::seq<16, 4>(instr);
+
+    bool writes = (writeback || !pre_index) && (!load || rd != rn);
+
+    if (rd == 15 || (writes && rn == 15) || (reg_op && bit::seq<4, 1>(instr)))
+        return std::string();
+
+    char sign = increment ? '+' : '-';
+
+    std::string code = shell::format("    {{\n        u32 addr = {};\n", reg(rn, addr + 8));
+    std::string offset = shell::format("0x{:X}", bit::seq<0, 12>(instr));
+
+    if (reg_op)
+    {
+        code += shell::format("        u32 offset = nativeShift(api, {}, {}, {}, false);\n",
+            bit::seq<5, 2>(instr), reg(bit::seq<0, 4>(instr), addr + 8), bit::seq<7, 5>(instr));
+
+        offset = "offset";
+    }
+
+    if (pre_index)
+        code += shell::format("        addr {}= {};\n", sign, offset);
+
+    if (load)
+        code += shell::format("        r[{}] = api->{}(addr);\n", rd, byte ? "loadByte" : "loadWord");
+    else
+        code += shell::format("        api->{}(addr, r[{}]);\n", byte ? "storeByte" : "storeWord", rd);
+
+    if (writes)
+    {
+        if (pre_index)
+            code += shell::format("        r[{}] = addr;\n", rn);
+        else
+            code += shell::format("        r[{}] = addr {} {};\n", rn, sign, offset);
+    }
+    return code + "    }\n";
+}
+
+static std::string translate(u32 instr, u32 addr, uint count)
+{
+    std::string code;
+    switch (decodeArm(hashArm(instr)))
+    {
+    case InstructionArm::DataProcessing:
+        code = translateDataProcessing(instr, addr);
+        break;
+
+    case InstructionArm::SingleDataTransfer:
+        code = translateSingleDataTransfer(instr, addr);
+        break;
+
+    case InstructionArm::BranchLink:
+        if (bit::seq<24, 1>(instr))
+            code = shell::format("    r[14] = 0x{:08X};\n", addr + 4);
+
+        code += shell::format("    api->branchArm(0x{:08X});\n    return {};\n",
+            addr + 8 + (bit::signEx<24>(bit::seq<0, 24>(instr)) << 2), count);
+        break;
+
+    default:
+        break;
+    }
+
+    uint condition = bit::seq<28, 4>(instr);
+    if (code.empty() || condition == 0xE)
+        return code;
+
+    std::string nested;
+    for (std::size_t begin = 0, end; begin < code.size(); begin = end + 1)
+    {
+        end = code.find('\n', begin);
+        nested += "    " + code.substr(begin, end - begin + 1);
+    }
+    return shell::format("    if (nativeCheck(api, 0x{:X}))\n    {{\n{}    }}\n", condition, nested);
+}
+
+template<typename Integral>
+static std::string emit(const Trace<Integral>& block)
+{
+    constexpr bool kThumb = sizeof(Integral) == 2;
+    constexpr uint kSize  = sizeof(Integral);
+
+    std::string code = shell::format("static uint block_{:08X}_{}()\n{{\n    u32* r = api->regs;\n    u32* p = api->pipe;\n    uint state = *api->state;\n\n",
+        block.addr, kThumb ? "thumb" : "arm");
+
+    for (uint x = 0; x < block.instrs.size(); ++x)
+    {
+        u32 addr = block.addr + kSize * x;
+
+        code += shell::format("    r[15] = 0x{:08X};\n    p[0] = 0x{:X};\n    p[1] = 0x{:X};\n    api->{}();\n",
+            addr + 2 * kSize,
+            readRom<Integral>(addr + 1 * kSize),
+            readRom<Integral>(addr + 2 * kSize),
+            kThumb ? "fetchThumb" : "fetchArm");
+
+        if (std::string native = translate(block.instrs[x], addr, x + 1); !native.empty())
+            code += native;
+        else
+            code += shell::format("    api->{}(0x{:X});\n", kThumb ? "executeThumb" : "executeArm", block.instrs[x]);
+
+        if (x + 1 < block.instrs.size())
+            code += shell::format("    if (*api->state != state) return {};\n", x + 1);
+    }
+
+    code += shell::format("    return {};\n}}\n\n", block.instrs.size());
+
+    return code;
+}
+
+Recompiler::~Recompiler()
+{
+    unload();
+}
+
+bool Recompiler::isLoaded() const
+{
+    return library;
+}
+
+bool Recompiler::load(const fs::path& rom)
+{
+    unload();
+
+    if (!config.native_code || gamepak.rom.empty())
+        return false;
+
+    fs::path file = fs::absolute(rom);
+    file.replace_extension(kExtension);
+    if (!fs::is_regular_file(file))
+        return false;
+
+    u64 hash = Recompiler::hash();
+
+    #if SHELL_OS_WINDOWS
+    library = LoadLibraryW(file.c_str());
+    #else
+    library = dlopen(file.c_str(), RTLD_NOW | RTLD_LOCAL);
+    #endif
+
+    if (!library)
+        return false;
+
+    #if SHELL_OS_WINDOWS
+    auto init = reinterpret_cast<NativeInit>(GetProcAddress(static_cast<HMODULE>(library), NATIVE_INIT));
+    #else
+    auto init = reinterpret_cast<NativeInit>(dlsym(library, NATIVE_INIT));
+    #endif
+
+    static const NativeApi kApi =
+    {
+        arm.regs.data(),
+        arm.pipe.data(),
+        &arm.state,
+        &arm.cpsr.zero,
+        &arm.cpsr.sign,
+        &arm.cpsr.carry,
+        &arm.cpsr.overflow,
+        &Recompiler::fetchArm,
+        &Recompiler::fetchThumb,
+        &Recompiler::executeArm,
+        &Recompiler::executeThumb,
+        &Recompiler::branchArm,
+        &Recompiler::branchThumb,
+        &Recompiler::loadByte,
+        &Recompiler::loadHalf,
+        &Recompiler::loadWord,
+        &Recompiler::loadByteSignEx,
+        &Recompiler::loadHalfSignEx,
+        &Recompiler::storeByte,
+        &Recompiler::storeHalf,
+        &Recompiler::storeWord
+    };
+
+    uint count = 0;
+    const NativeBlock* data = init ? init(&kApi, hash, &count) : nullptr;
+    if (!data)
+    {
+        unload();
+        return false;
+    }
+
+    for (uint x = 0; x < count; ++x)
+        blocks[key(data[x].addr, data[x].thumb)] = data[x];
+
+    return true;
+}
+
+void Recompiler::unload()
+{
+    blocks.clear();
+
+    if (!library)
+        return;
+
+    #if SHELL_OS_WINDOWS
+    FreeLibrary(static_cast<HMODULE>(library));
+    #else
+    dlclose(library);
+    #endif
+
+    library = nullptr;
+}
+
+bool Recompiler::generate(const fs::path& file) const
+{
+    std::vector<Trace<u16>> traces_thumb;
+    std::vector<Trace<u32>> traces_arm;
+
+    std::set<u32> seen;
+    std::vector<u32> work = { key(0x0800'0000, false) };
+
+    u32 irq = arm.iwram->readFast<u32>(0x7FFC);
+    if (isRom(irq & ~0x3, 4))
+        work.push_back(key(irq & ~0x3, false));
+
+    while (!work.empty())
+    {
+        u32 next = work.back();
+        work.pop_back();
+
+        bool thumb = next & 0x1;
+        u32  addr  = next & ~0x1;
+
+        if (addr & (thumb ? 0x1 : 0x3) || !isRom(addr, 1) || !seen.insert(next).second)
+            continue;
+
+        if (thumb)
+        {
+            Trace<u16> block;
+            if (discover(addr, Arm::BlockCacheThumb::Block::kMaxSize, block))
+            {
+                targets(block, work);
+                traces_thumb.push_back(std::move(block));
+            }
+        }
+        else
+        {
+            Trace<u32> block;
+            if (discover(addr, Arm::BlockCacheArm::Block::kMaxSize, block))
+            {
+                targets(block, work);
+                traces_arm.push_back(std::move(block));
+            }
+        }
+    }
+
+    std::string table;
+    std::string data = shell::format(
+        "// {} ({})\n"
+        "// Build with the eggvance NATIVE_ROM target or place <rom name>{} next to the ROM\n\n"
+        "#include \"arm/native.h\"\n\n"
+        "static const NativeApi* api = nullptr;\n\n",
+        gamepak.rom.title, gamepak.rom.code, kExtension);
+
+    for (const auto& block : traces_arm)
+    {
+        data  += emit(block);
+        table += shell::format("    {{ 0x{:08X}, {}, 0, &block_{:08X}_arm }},\n", block.addr, block.instrs.size(), block.addr);
+    }
+
+    for (const auto& block : traces_thumb)
+    {
+        data  += emit(block);
+        table += shell::format("    {{ 0x{:08X}, {}, 1, &block_{:08X}_thumb }},\n", block.addr, block.instrs.size(), block.addr);
+    }
+
+    data += shell::format(
+        "static const NativeBlock kBlocks[] =\n{{\n{}}};\n\n"
+        "NATIVE_EXPORT const NativeBlock* eggvance_native(const NativeApi* native, u64 hash, uint* count)\n"
+        "{{\n"
+        "    if (hash != 0x{:016X}ull)\n"
+        "        return nullptr;\n\n"
+        "    api = native;\n"
+        "    *count = {};\n"
+        "    return kBlocks;\n"
+        "}}\n",
+        table, hash(), traces_arm.size() + traces_thumb.size());
+
+    return fs::write(file, data) == fs::Status::Ok;
+}
+
+Recompiler::Code Recompiler::find(u32 addr, bool thumb, uint size) const
+{
+    if (blocks.empty())
+        return nullptr;
+
+    auto iter = blocks.find(key(addr, thumb));
+    if ( iter == blocks.end() || iter->second.size != size)
+        return nullptr;
+
+    return iter->second.code;
+}
+
+u64 Recompiler::hash()
+{
+    u64 hash = 0xCBF2'9CE4'8422'2325;
+    for (u8 byte : gamepak.rom)
+    {
+        hash ^= byte;
+        hash *= 0x100'0000'01B3;
+    }
+    return hash;
+}
+
+void Recompiler::fetchArm()
+{
+    arm.tickRom(arm.pc, arm.waitcnt.waitWord(arm.pc, arm.pipe.access));
+    arm.pipe.access = Access::Sequential;
+}
+
+void Recompiler::fetchThumb()
+{
+    arm.tickRom(arm.pc, arm.waitcnt.waitHalf(arm.pc, arm.pipe.access));
+    arm.pipe.access = Access::Sequential;
+}
+
+void Recompiler::executeArm(u32 instr)
+{
+    if (arm.cpsr.check(instr >> 28))
+        Arm::instr_arm[hashArm(instr)](arm, instr);
+
+    arm.cpsr.resolve();
+}
+
+void Recompiler::executeThumb(u32 instr)
+{
+    Arm::instr_thumb[hashThumb(instr)](arm, static_cast<u16>(instr));
+
+    arm.cpsr.resolve();
+}
+
+void Recompiler::branchArm(u32 addr)
+{
+    arm.pc = addr;
+    arm.flushWord();
+}
+
+void Recompiler::branchThumb(u32 addr)
+{
+    arm.pc = addr;
+    arm.flushHalf();
+}
+
+u32 Recompiler::loadByte(u32 addr)
+{
+    u32 value = arm.readByte(addr);
+    arm.idle();
+    return value;
+}
+
+u32 Recompiler::loadHalf(u32 addr)
+{
+    u32 value = arm.readHalfRotate(addr);
+    arm.idle();
+    return value;
+}
+
+u32 Recompiler::loadWord(u32 addr)
+{
+    u32 value = arm.readWordRotate(addr);
+    arm.idle();
+    return value;
+}
+
+u32 Recompiler::loadByteSignEx(u32 addr)
+{
+    u32 value = arm.readByteSignEx(addr);
+    arm.idle();
+    return value;
+}
+
+u32 Recompiler::loadHalfSignEx(u32 addr)
+{
+    u32 value = arm.readHalfSignEx(addr);
+    arm.idle();
+    return value;
+}
+
+void Recompiler::storeByte(u32 addr, u32 value)
+{
+    arm.writeByte(addr, value);
+}
+
+void Recompiler::storeHalf(u32 addr, u32 value)
+{
+    arm.writeHalf(addr, value);
+}
+
+void Recompiler::storeWord(u32 addr, u32 value)
+{
+    arm.writeWord(addr, value);
+}
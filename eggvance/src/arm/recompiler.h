@@ -0,0 +1,44 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "native.h"
+#include "base/filesystem.h"
+
+class Recompiler
+{
+public:
+    using Code = uint(*)();
+
+    ~Recompiler();
+
+    bool isLoaded() const;
+
+    bool load(const fs::path& rom);
+    void unload();
+    bool generate(const fs::path& file) const;
+
+    Code find(u32 addr, bool thumb, uint size) const;
+
+private:
+    static u64 hash();
+    static void fetchArm();
+    static void fetchThumb();
+    static void executeArm(u32 instr);
+    static void executeThumb(u32 instr);
+    static void branchArm(u32 addr);
+    static void branchThumb(u32 addr);
+    static u32 loadByte(u32 addr);
+    static u32 loadHalf(u32 addr);
+    static u32 loadWord(u32 addr);
+    static u32 loadByteSignEx(u32 addr);
+    static u32 loadHalfSignEx(u32 addr);
+    static void storeByte(u32 addr, u32 value);
+    static void storeHalf(u32 addr, u32 value);
+    static void storeWord(u32 addr, u32 value);
+
+    void* library = nullptr;
+    std::unordered_map<u32, NativeBlock> blocks;
+};
+
+inline Recompiler recompiler;
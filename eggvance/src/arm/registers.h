@@ -22,19 +22,4 @@ class Registers
     };
 
     Psr cpsr;
-    Psr spsr;
-
-protected:
-    void switchMode(Psr::Mode mode);
-
-private:
-    enum class Bank { Def, Fiq, Irq, Svc, Abt, Und };
-
-    static Bank modeToBank(Psr::Mode mode);
-
-    struct Banks
-    {
-        shell::array<u32, 6, 3> def = {};
-        shell::array<u32, 2, 5> fiq = {};
-    } banks;
 };
@@ -8,7 +8,7 @@ SHELL_INLINE u32 Arm::lsl(u32 value, u32 amount, bool flags)
         if (amount < 32)
         {
             if (flags)
-                cpsr.c = (value << (amount - 1)) >> 31;
+                cpsr.setC((value << (amount - 1)) >> 31);
 
             value <<= amount;
         }
@@ -17,9 +17,9 @@ SHELL_INLINE u32 Arm::lsl(u32 value, u32 amount, bool flags)
             if (flags)
             {
                 if (amount == 32)
-                    cpsr.c = value & 0x1;
+                    cpsr.setC(value & 0x1);
                 else
-                    cpsr.c = 0;
+                    cpsr.setC(0);
             }
             value = 0;
         }
@@ -35,7 +35,7 @@ SHELL_INLINE u32 Arm::lsr(u32 value, u32 amount, bool flags)
         if (amount < 32)
         {
             if (flags)
-                cpsr.c = (value >> (amount - 1)) & 0x1;
+                cpsr.setC((value >> (amount - 1)) & 0x1);
 
             value >>= amount;
         }
@@ -44,9 +44,9 @@ SHELL_INLINE u32 Arm::lsr(u32 value, u32 amount, bool flags)
             if (flags)
             {
                 if (amount == 32)
-                    cpsr.c = value >> 31;
+                    cpsr.setC(value >> 31);
                 else
-                    cpsr.c = 0;
+                    cpsr.setC(0);
             }
             value = 0;
         }
@@ -54,7 +54,7 @@ SHELL_INLINE u32 Arm::lsr(u32 value, u32 amount, bool flags)
     else if (kImmediate)
     {
         if (flags)
-            cpsr.c = value >> 31;
+            cpsr.setC(value >> 31);
 
         value = 0;
     }
@@ -69,7 +69,7 @@ SHELL_INLINE u32 Arm::asr(u32 value, u32 amount, bool flags)
         if (amount < 32)
         {
             if (flags)
-                cpsr.c = (value >> (amount - 1)) & 0x1;
+                cpsr.setC((value >> (amount - 1)) & 0x1);
 
             value = bit::sar(value, amount);
         }
@@ -78,7 +78,7 @@ SHELL_INLINE u32 Arm::asr(u32 value, u32 amount, bool flags)
             value = bit::sar(value, 31);
 
             if (flags)
-                cpsr.c = value & 0x1;
+                cpsr.setC(value & 0x1);
         }
     }
     else if (kImmediate)
@@ -86,7 +86,7 @@ SHELL_INLINE u32 Arm::asr(u32 value, u32 amount, bool flags)
         value = bit::sar(value, 31);
 
         if (flags)
-            cpsr.c = value & 0x1;
+            cpsr.setC(value & 0x1);
     }
     return value;
 }
@@ -99,14 +99,14 @@ SHELL_INLINE u32 Arm::ror(u32 value, u32 amount, bool flags)
         value = bit::ror(value, amount);
 
         if (flags)
-            cpsr.c = value >> 31;
+            cpsr.setC(value >> 31);
     }
     else if (kImmediate)
     {
-        uint c = cpsr.c;
+        uint c = cpsr.c();
 
         if (flags)
-            cpsr.c = value & 0x1;
+            cpsr.setC(value & 0x1);
 
         value = (c << 31) | (value >> 1);
     }
@@ -11,26 +11,59 @@ SHELL_INLINE void Arm::idle(u64 cycles)
     tickRam(cycles);
 }
 
+// Data accesses, idle cycles, multiplies and open bus reads come from
+// handlers shared by all tiers and test the tier bit at run time. Only
+// instruction fetches in dispatch are specialized per tier.
 SHELL_INLINE void Arm::tickRam(u64 cycles)
 {
-    if (prefetch.active && !(state & State::Dma) && waitcnt.prefetch)
-        prefetch.cycles += cycles;
+    if (state & State::Fast)
+        tickRam<Accuracy::Fast>(cycles);
+    else
+        tickRam<Accuracy::Accurate>(cycles);
+}
+
+SHELL_INLINE void Arm::tickRom(u32 addr, u64 cycles)
+{
+    if (state & State::Fast)
+        tickRom<Accuracy::Fast>(addr, cycles);
+    else
+        tickRom<Accuracy::Accurate>(addr, cycles);
+}
 
+SHELL_INLINE void Arm::tickMultiply(u32 multiplier, bool sign)
+{
+    if (accuracy(state) == Accuracy::Accurate)
+        tickMultiply<Accuracy::Accurate>(multiplier, sign);
+    else
+        tickMultiply<Accuracy::Balanced>(multiplier, sign);
+}
+
+template<Accuracy kAccuracy>
+SHELL_INLINE void Arm::tickRam(u64 cycles)
+{
+    if constexpr (kAccuracy != Accuracy::Fast)
+    {
+        if (prefetch.active && !(state & State::Dma) && waitcnt.prefetch)
+            prefetch.cycles += cycles;
+    }
     scheduler.run(cycles);
 }
 
+template<Accuracy kAccuracy>
 SHELL_INLINE void Arm::tickRom(u32 addr, u64 cycles)
 {
-    if (!(state & State::Dma) && waitcnt.prefetch)
+    if constexpr (kAccuracy == Accuracy::Fast)
+    {
+        if (addr == pc && !(state & State::Dma) && waitcnt.prefetch)
+            cycles = 1;
+    }
+    else if (!(state & State::Dma) && waitcnt.prefetch)
     {
         prefetch.active = addr == pc;
 
         if (prefetch.active && prefetch.cycles)
         {
-            u64 non = waitcnt.waitHalf(addr, Access::NonSequential);
-            u64 seq = waitcnt.waitHalf(addr, Access::Sequential);
-
-            cycles -= non - seq + std::min(8 * seq, prefetch.cycles);
+            cycles -= waitcnt.prefetchSkip(addr) + std::min(waitcnt.prefetchSize(addr), prefetch.cycles);
 
             if (static_cast<s64>(cycles) <= 0)
             {
@@ -43,10 +76,17 @@ SHELL_INLINE void Arm::tickRom(u32 addr, u64 cycles)
     scheduler.run(cycles);
 }
 
+template<Accuracy kAccuracy>
 SHELL_INLINE void Arm::tickMultiply(u32 multiplier, bool sign)
 {
+    if constexpr (kAccuracy != Accuracy::Accurate)
+    {
+        idle();
+        return;
+    }
+
     u64 cycles = 1;
-    
+
     for (uint mask = 0xFFFF'FF00; mask; mask <<= 8)
     {
         multiplier &= mask;
@@ -103,10 +103,16 @@ Config::~Config()
     set("settings",   "save_path",             shell::format(save_path));
     set("settings",   "bios_file",             shell::format(bios_file));
     set("settings",   "bios_skip",             shell::format(bios_skip));
+    set("settings",   "bios_hle",              shell::format(bios_hle));
     set("emulation",  "fast_forward",          shell::format(fast_forward));
+    set("emulation",  "jit",                   shell::format(jit));
+    set("emulation",  "idle_loops",            shell::format(idle_loops));
+    set("emulation",  "native_code",           shell::format(native_code));
+    set("emulation",  "accuracy",              shell::format(accuracy));
     set("video",      "frame_size",            shell::format(frame_size));
     set("video",      "color_correct",         shell::format(color_correct));
     set("video",      "preserve_aspect_ratio", shell::format(preserve_aspect_ratio));
+    set("video",      "render_thread",         shell::format(render_thread));
     set("audio",      "mute",                  shell::format(mute));
     set("audio",      "volume",                shell::format(volume));
     set("video",      "video_layers",          shell::format(video_layers));
@@ -145,10 +151,16 @@ void Config::init()
     save_path             = findOr("settings",   "save_path",             fs::path());
     bios_file             = findOr("settings",   "bios_file",             fs::path());
     bios_skip             = findOr("settings",   "bios_skip",             true);
+    bios_hle              = findOr("settings",   "bios_hle",              false);
     fast_forward          = findOr("emulation",  "fast_forward",          1'000'000);
+    jit                   = findOr("emulation",  "jit",                   false);
+    idle_loops            = findOr("emulation",  "idle_loops",            false);
+    native_code           = findOr("emulation",  "native_code",           false);
+    accuracy              = findOr("emulation",  "accuracy",              0);
     frame_size            = findOr("video",      "frame_size",            4);
     color_correct         = findOr("video",      "color_correct",         true);
     preserve_aspect_ratio = findOr("video",      "preserve_aspect_ratio", true);
+    render_thread         = findOr("video",      "render_thread",         false);
     mute                  = findOr("audio",      "mute",                  false);
     volume                = findOr("audio",      "volume",                0.5);
     video_layers          = findOr("video",      "video_layers",          0b11111);
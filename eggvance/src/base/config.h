@@ -76,11 +76,17 @@ class Config : public Ini
     fs::path    save_path;
     fs::path    bios_file;
     bool        bios_skip;
+    bool        bios_hle;
     RecentFiles recent;
     uint        fast_forward;
+    bool        jit;
+    bool        idle_loops;
+    bool        native_code;
+    uint        accuracy;
     uint        frame_size;
     bool        color_correct;
     bool        preserve_aspect_ratio;
+    bool        render_thread;
     bool        mute;
     float       volume;
     uint        video_layers;
@@ -4,7 +4,7 @@
 
 void Dma::run()
 {
-    while (active && scheduler.now < arm.target)
+    while (active && !(arm.state & Arm::State::Exit))
     {
         active->run();
 
@@ -34,6 +34,16 @@ void Dma::broadcast(Event event)
     }
 }
 
+bool Dma::waits(Event event) const
+{
+    for (const auto& channel : channels)
+    {
+        if (channel.control.enabled && triggers(channel, event))
+            return true;
+    }
+    return false;
+}
+
 void Dma::emit(DmaChannel& channel, Event event)
 {
     if (!channel.control.enabled || channel.running || !triggers(channel, event))
@@ -20,6 +20,7 @@ class Dma
     void run();
     void emit(DmaChannel& channel, Event event);
     void broadcast(Event event);
+    bool waits(Event event) const;
 
     shell::array<DmaChannel, 4> channels = { 0, 1, 2, 3 };
 
@@ -78,17 +78,17 @@ void DmaChannel::run()
             if (!(latch.sad.isGamePak() && latch.dad.isGamePak()))
                 arm.idle(2);
 
-            transfer(Access::NonSequential);
+            (this->*transfer)(Access::NonSequential);
         }
         else
         {
-            transfer(Access::Sequential);
+            (this->*transfer)(Access::Sequential);
         }
 
         latch.sad = latch.sad + kSadDeltas[latch.word][latch.sadcnt];
         latch.dad = latch.dad + kDadDeltas[latch.word][latch.dadcnt];
 
-        if (pending && arm.target >= scheduler.now)
+        if (pending && arm.target >= scheduler.now())
             return;
     }
 
@@ -136,56 +136,54 @@ void DmaChannel::initTransfer()
     {
         initEeprom();
 
-        if (eeprom_r)
-        {
-            transfer = [this](Access access)
-            {
-                if (latch.sad < 0x200'0000)
-                    arm.idle();
-                else
-                    bus = gamepak.save->read(latch.sad);
-                
-                arm.writeHalf(latch.dad, bus, access);
-            };
-        }
-        else
-        {
-            transfer = [this](Access access)
-            {
-                if (latch.sad < 0x200'0000) 
-                    arm.idle();
-                else
-                    bus = arm.readHalf(latch.sad, access) * 0x0001'0001;
-
-                gamepak.save->write(latch.dad, bus);
-            };
-        }
+        transfer = eeprom_r
+            ? &DmaChannel::transferEepromRead
+            : &DmaChannel::transferEepromWrite;
     }
     else
     {
-        if (latch.word)
-        {
-            transfer = [this](Access access)
-            {
-                if (latch.sad < 0x200'0000)
-                    arm.idle();
-                else
-                    bus = arm.readWord(latch.sad, access);
-                
-                arm.writeWord(latch.dad, bus, access);
-            };
-        }
-        else
-        {
-            transfer = [this](Access access)
-            {
-                if (latch.sad < 0x200'0000)
-                    arm.idle();
-                else
-                    bus = arm.readHalf(latch.sad, access) * 0x0001'0001;
-
-                arm.writeHalf(latch.dad, bus, access);
-            };
-        }
+        transfer = latch.word
+            ? &DmaChannel::transferWord
+            : &DmaChannel::transferHalf;
     }
 }
+
+void DmaChannel::transferEepromRead(Access access)
+{
+    if (latch.sad < 0x200'0000)
+        arm.idle();
+    else
+        bus = gamepak.save->read(latch.sad);
+
+    arm.writeHalf(latch.dad, bus, access);
+}
+
+void DmaChannel::transferEepromWrite(Access access)
+{
+    if (latch.sad < 0x200'0000)
+        arm.idle();
+    else
+        bus = arm.readHalf(latch.sad, access) * 0x0001'0001;
+
+    gamepak.save->write(latch.dad, bus);
+}
+
+void DmaChannel::transferWord(Access access)
+{
+    if (latch.sad < 0x200'0000)
+        arm.idle();
+    else
+        bus = arm.readWord(latch.sad, access);
+
+    arm.writeWord(latch.dad, bus, access);
+}
+
+void DmaChannel::transferHalf(Access access)
+{
+    if (latch.sad < 0x200'0000)
+        arm.idle();
+    else
+        bus = arm.readHalf(latch.sad, access) * 0x0001'0001;
+
+    arm.writeHalf(latch.dad, bus, access);
+}
@@ -1,7 +1,5 @@
 #pragma once
 
-#include <functional>
-
 #include "dmaaddress.h"
 #include "io.h"
 #include "arm/constants.h"
@@ -26,6 +24,10 @@ class DmaChannel
 private:
     void initEeprom();
     void initTransfer();
+    void transferEepromRead(Access access);
+    void transferEepromWrite(Access access);
+    void transferWord(Access access);
+    void transferHalf(Access access);
 
     uint running = 0;
     uint pending = 0;
@@ -42,5 +44,5 @@ class DmaChannel
         DmaAddress dad;
     } latch;
 
-    std::function<void(Access)> transfer;
+    void(DmaChannel::*transfer)(Access) = nullptr;
 };
@@ -3,6 +3,7 @@
 #include <shell/operators.h>
 
 #include "dma.h"
+#include "ppu/ppu.h"
 
 DmaSrcAddress::DmaSrcAddress(uint id)
     : RegisterW(id == 0 ? 0x07FF'FFFF : 0x0FFF'FFFF)
@@ -57,6 +58,7 @@ void DmaControl::write(uint index, u8 byte)
         return;
 
     uint was_enabled = enabled;
+    uint was_timing  = timing;
 
     repeat  = bit::seq<1, 1>(byte);
     word    = bit::seq<2, 1>(byte);
@@ -71,6 +73,9 @@ void DmaControl::write(uint index, u8 byte)
         if (timing == Timing::Immediate)
             dma.emit(channel, Dma::Event::Immediate);
     }
+
+    if (was_enabled != enabled || was_timing != timing)
+        ppu.schedule();
 }
 
 void DmaControl::setEnabled(bool enabled)
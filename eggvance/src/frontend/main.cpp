@@ -14,6 +14,7 @@
 #include "videocontext.h"
 #include "apu/apu.h"
 #include "arm/arm.h"
+#include "arm/recompiler.h"
 #include "base/config.h"
 #include "dma/dma.h"
 #include "gamepak/gamepak.h"
@@ -26,6 +27,11 @@
 
 enum class State { Quit, Menu, Run, Pause };
 
+constexpr auto kPixelsHor   = kScreenW + 68;
+constexpr auto kPixelsVer   = kScreenH + 68;
+constexpr auto kPixelCycles = 4;
+constexpr auto kFrameCycles = kPixelCycles * kPixelsHor * kPixelsVer;
+
 State state;
 FrameCounter counter;
 FrameRateLimiter limiter;
@@ -73,12 +79,15 @@ void updateTitle()
 
 void updateTitle(double fps)
 {
-    const auto title = shell::format(
+    auto title = shell::format(
         gamepak.rom.title.empty()
             ? "eggvance - {1:.1f} fps"
             : "eggvance - {0} - {1:.1f} fps",
         gamepak.rom.title, fps);
 
+    if (config.idle_loops)
+        title += shell::format(" - {:.1f}% idle", 100.0 * arm.idle_cycles / kFrameCycles);
+
     video_ctx.setTitle(title);
 }
 
@@ -129,6 +138,9 @@ void load(const std::optional<fs::path>& rom, const std::optional<fs::path>& sav
             rom.value_or(fs::path()),
             sav.value_or(fs::path()));
 
+        if (rom)
+            recompiler.load(*rom);
+
         reset();
 
         audio_ctx.unpause();
@@ -136,6 +148,22 @@ void load(const std::optional<fs::path>& rom, const std::optional<fs::path>& sav
     queueReset();
 }
 
+void toggleProfiler()
+{
+    if (!profiler.isActive())
+    {
+        profiler.clear();
+        profiler.start();
+        return;
+    }
+    profiler.stop();
+
+    auto file = *config.recent.begin();
+    profiler.writeFolded(file.replace_extension("folded"));
+    profiler.writeFlat(file.replace_extension("profile"));
+    profiler.writePairs(file.replace_extension("pairs"));
+}
+
 void setFastForward(double fast_forward)
 {
     if (limiter.isFastForward())
@@ -477,6 +505,32 @@ float doUi()
                 }
                 ImGui::EndMenu();
             }
+
+            ImGui::Separator();
+
+            if (ImGui::MenuItem("JIT", nullptr, config.jit, Jit::isSupported()))
+                config.jit = !config.jit;
+
+            if (ImGui::MenuItem("Idle loop skipping", nullptr, config.idle_loops))
+                config.idle_loops = !config.idle_loops;
+
+            #if PROFILER_ENABLED
+            ImGui::Separator();
+
+            if (ImGui::BeginMenu("Profiler", isRunning()))
+            {
+                if (ImGui::MenuItem("Record", nullptr, profiler.isActive()))
+                    toggleProfiler();
+
+                if (ImGui::MenuItem("Load symbols"))
+                {
+                    if (const auto file = openFileDialog("elf,sym"))
+                        profiler.loadSymbols(*file);
+                }
+                ImGui::EndMenu();
+            }
+            #endif
+
             ImGui::EndMenu();
         }
 
@@ -631,6 +685,11 @@ float doUi()
         ImGui::SettingsLabel("Skip BIOS");
         ImGui::Checkbox("", &config.bios_skip);
 
+        ImGui::PushID("HLE");
+        ImGui::SettingsLabel("BIOS HLE ");
+        ImGui::Checkbox("", &config.bios_hle);
+        ImGui::PopID();
+
         ImGui::EndSettingsWindow();
     }
 
@@ -743,16 +802,57 @@ void renderUi()
         ImGui_ImplOpenGL2_RenderDrawData(ImGui::GetDrawData());
 }
 
+int recompile(const std::optional<fs::path>& rom, const fs::path& file)
+{
+    if (!rom)
+    {
+        shell::print("Cannot recompile without a ROM\n");
+        return 1;
+    }
+
+    gamepak.load(*rom, fs::path());
+
+    if (gamepak.rom.empty())
+    {
+        shell::print("Cannot load ROM: {}\n", rom->string());
+        return 1;
+    }
+
+    Bios::init(config.bios_file);
+    arm.init();
+
+    if (!recompiler.generate(file))
+    {
+        shell::print("Cannot write recompiled source: {}\n", file.string());
+        return 1;
+    }
+    return 0;
+}
+
+void benchmark(uint frames)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    const auto begin = Clock::now();
+
+    for (uint x = 0; x < frames; ++x)
+        arm.run(kFrameCycles);
+
+    const auto seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    shell::print("{} frames in {:.2f} s - {:.1f} fps - {:.1f} MIPS\n",
+        frames, seconds, frames / seconds, arm.instructions / seconds / 1'000'000);
+
+    if (ppu.lines_rendered)
+        shell::print("{:.1f}% of lines reused\n", 100.0 * ppu.lines_reused / ppu.lines_rendered);
+}
+
 void frame(State state)
 {
     if (state == State::Run)
     {
-        constexpr auto kPixelsHor   = kScreenW + 68;
-        constexpr auto kPixelsVer   = kScreenH + 68;
-        constexpr auto kPixelCycles = 4;
-        constexpr auto kFrameCycles = kPixelCycles * kPixelsHor * kPixelsVer;
-
         keypad.update();
+        arm.idle_cycles = 0;
         arm.run(kFrameCycles);
     }
     else
@@ -817,8 +917,11 @@ void init(int argc, char* argv[])
     using namespace shell;
 
     Options options("eggvance");
-    options.add({ "rom",       "ROM file"          }, Options::value<fs::path>()->positional()->optional());
-    options.add({ "-s,--save", "save file", "file" }, Options::value<fs::path>()->optional());
+    options.add({ "rom",            "ROM file"                             }, Options::value<fs::path>()->positional()->optional());
+    options.add({ "-s,--save",      "save file",                 "file"   }, Options::value<fs::path>()->optional());
+    options.add({ "-b,--benchmark", "run frames and print MIPS", "frames" }, Options::value<uint>()->optional());
+    options.add({ "-r,--recompile", "write ROM as C++ source",   "file"   }, Options::value<fs::path>()->optional());
+    options.add({ "-a,--accuracy",  "timing accuracy (0 - 2)",   "tier"   }, Options::value<uint>()->optional());
 
     OptionsResult result;
     try
@@ -834,6 +937,12 @@ void init(int argc, char* argv[])
 
     config.init();
 
+    if (const auto accuracy = result.find<uint>("--accuracy"))
+        config.accuracy = *accuracy;
+
+    if (const auto file = result.find<fs::path>("--recompile"))
+        std::exit(recompile(result.find<fs::path>("rom"), *file));
+
     audio_ctx.init();
     input_ctx.init();
     video_ctx.init();
@@ -852,6 +961,12 @@ void init(int argc, char* argv[])
     const auto sav = result.find<fs::path>("--save");
 
     load(rom, sav);
+
+    if (const auto frames = result.find<uint>("--benchmark"); frames && state == State::Run)
+    {
+        benchmark(*frames);
+        state = State::Quit;
+    }
 }
 
 int main(int argc, char* argv[])
@@ -33,7 +33,8 @@ class VideoContext
 
         shell::print("{}\n", message);
 
-        SDL_ShowSimpleMessageBox(0, title.c_str(), message.c_str(), window);
+        if (window)
+            SDL_ShowSimpleMessageBox(0, title.c_str(), message.c_str(), window);
     }
 
     SDL_Window* window = nullptr;
@@ -7,7 +7,7 @@
 #include "base/config.h"
 #include "frontend/videocontext.h"
 
-void Ppu::compose(uint possible)
+void Ppu::compose(uint possible, bool simd)
 {
     BackgroundLayers layers;
 
@@ -21,19 +21,28 @@ void Ppu::compose(uint possible)
 
     std::sort(layers.begin(), layers.end());
 
-    if (dispcnt.win0 || dispcnt.win1 || dispcnt.winobj)
-    {
-        uint windows = 0;
+    bool windowed = dispcnt.win0 || dispcnt.win1 || dispcnt.winobj;
+    uint windows  = 0;
 
-        if (dispcnt.win0 && winv[0].contains(vcount))
-            windows |= Window::Flag::Win0;
+    if (dispcnt.win0 && winv[0].contains(vcount))
+        windows |= Window::Flag::Win0;
 
-        if (dispcnt.win1 && winv[1].contains(vcount))
-            windows |= Window::Flag::Win1;
+    if (dispcnt.win1 && winv[1].contains(vcount))
+        windows |= Window::Flag::Win1;
 
-        if (dispcnt.winobj && objects_exist)
-            windows |= Window::Flag::WinObj;
+    if (dispcnt.winobj && objects_exist)
+        windows |= Window::Flag::WinObj;
 
+    #if SIMD_ENABLED
+    if (simd)
+    {
+        composeSimd(layers, windowed, windows);
+        return;
+    }
+    #endif
+
+    if (windowed)
+    {
         if (bldcnt.mode != BlendMode::Disabled || objects_alpha)
         {
             switch (objects_exist | (bldcnt.mode << 1) | (windows << 3))
@@ -0,0 +1,210 @@
+#include "ppu.h"
+
+#if SIMD_ENABLED
+
+#include <emmintrin.h>
+#include <shell/macros.h>
+#include <shell/operators.h>
+
+#include "color.h"
+#include "frontend/videocontext.h"
+
+SHELL_INLINE static __m128i load(const u16* data)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+SHELL_INLINE static __m128i select(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+SHELL_INLINE static __m128i nonzero(__m128i value)
+{
+    return _mm_xor_si128(_mm_cmpeq_epi16(value, _mm_setzero_si128()), _mm_set1_epi16(-1));
+}
+
+template<int kShift>
+SHELL_INLINE static __m128i channel(__m128i color)
+{
+    return _mm_and_si128(_mm_srli_epi16(color, kShift), _mm_set1_epi16(0x1F));
+}
+
+template<int kShift>
+SHELL_INLINE static __m128i blendAlpha(__m128i a, __m128i b, __m128i eva, __m128i evb)
+{
+    __m128i value = _mm_add_epi16(
+        _mm_mullo_epi16(channel<kShift>(a), eva),
+        _mm_mullo_epi16(channel<kShift>(b), evb));
+
+    return _mm_slli_epi16(_mm_min_epi16(_mm_srli_epi16(value, 4), _mm_set1_epi16(0x1F)), kShift);
+}
+
+template<int kShift>
+SHELL_INLINE static __m128i blendWhite(__m128i a, __m128i evy)
+{
+    __m128i value = channel<kShift>(a);
+    __m128i delta = _mm_mullo_epi16(_mm_sub_epi16(_mm_set1_epi16(0x1F), value), evy);
+
+    return _mm_slli_epi16(_mm_add_epi16(value, _mm_srli_epi16(delta, 4)), kShift);
+}
+
+template<int kShift>
+SHELL_INLINE static __m128i blendBlack(__m128i a, __m128i evy)
+{
+    // Green and blue borrow like the in-place subtraction in BlendFade::blendBlack
+    __m128i value = channel<kShift>(a);
+    __m128i delta = _mm_add_epi16(_mm_mullo_epi16(value, evy), _mm_set1_epi16(kShift ? 0xF : 0));
+
+    return _mm_slli_epi16(_mm_sub_epi16(value, _mm_srli_epi16(delta, 4)), kShift);
+}
+
+SHELL_INLINE static __m128i blendAlpha(__m128i a, __m128i b, __m128i eva, __m128i evb)
+{
+    return _mm_or_si128(_mm_or_si128(
+        blendAlpha< 0>(a, b, eva, evb),
+        blendAlpha< 5>(a, b, eva, evb)),
+        blendAlpha<10>(a, b, eva, evb));
+}
+
+SHELL_INLINE static __m128i blendWhite(__m128i a, __m128i evy)
+{
+    return _mm_or_si128(_mm_or_si128(
+        blendWhite< 0>(a, evy),
+        blendWhite< 5>(a, evy)),
+        blendWhite<10>(a, evy));
+}
+
+SHELL_INLINE static __m128i blendBlack(__m128i a, __m128i evy)
+{
+    return _mm_or_si128(_mm_or_si128(
+        blendBlack< 0>(a, evy),
+        blendBlack< 5>(a, evy)),
+        blendBlack<10>(a, evy));
+}
+
+void Ppu::composeSimd(const BackgroundLayers& layers, bool windowed, uint windows)
+{
+    alignas(16) u16 enabled[kScreenW];
+    alignas(16) u16 blend[kScreenW];
+    alignas(16) u16 object_color[kScreenW];
+    alignas(16) u16 object_priority[kScreenW];
+    alignas(16) u16 object_alpha[kScreenW];
+    alignas(16) u16 result[kScreenW];
+
+    for (uint x = 0; x < kScreenW; ++x)
+    {
+        const auto& object = objects[x];
+        const auto* window = &winout.winout;
+
+        if ((windows & Window::Flag::Win0) && winh[0].contains(x))
+            window = &winin.win0;
+        else if ((windows & Window::Flag::Win1) && winh[1].contains(x))
+            window = &winin.win1;
+        else if ((windows & Window::Flag::WinObj) && object.window)
+            window = &winout.winobj;
+
+        enabled[x] = windowed ? window->enabled : 0x3F;
+        blend[x]   = windowed && !window->blend ? 0 : 0xFFFF;
+
+        bool visible = objects_exist && (enabled[x] & uint(Layer::Flag::Obj)) && object.isOpaque();
+
+        object_color[x]    = visible ? object.color : kTransparent;
+        object_priority[x] = object.priority;
+        object_alpha[x]    = objects_exist && object.alpha ? 0xFFFF : 0;
+    }
+
+    const __m128i transparent = _mm_set1_epi16(kTransparent);
+    const __m128i backdrop    = _mm_set1_epi16(pram.backdrop());
+    const __m128i flag_obj    = _mm_set1_epi16(uint(Layer::Flag::Obj));
+    const __m128i flag_bdp    = _mm_set1_epi16(uint(Layer::Flag::Bdp));
+    const __m128i bld_upper   = _mm_set1_epi16(bldcnt.upper);
+    const __m128i bld_lower   = _mm_set1_epi16(bldcnt.lower);
+    const __m128i eva         = _mm_set1_epi16(bldalpha.eva);
+    const __m128i evb         = _mm_set1_epi16(bldalpha.evb);
+    const __m128i evy         = _mm_set1_epi16(bldfade.evy);
+
+    bool blending = bldcnt.mode != BlendMode::Disabled || objects_alpha;
+
+    for (uint x = 0; x < kScreenW; x += 8)
+    {
+        __m128i upper = backdrop;
+        __m128i lower = backdrop;
+        __m128i upper_flag = flag_bdp;
+        __m128i lower_flag = flag_bdp;
+
+        auto push = [&](__m128i mask, __m128i color, __m128i flag)
+        {
+            lower      = select(mask, upper, lower);
+            lower_flag = select(mask, upper_flag, lower_flag);
+            upper      = select(mask, color, upper);
+            upper_flag = select(mask, flag, upper_flag);
+        };
+
+        __m128i layer_enabled = load(enabled + x);
+        __m128i object = load(object_color + x);
+        __m128i priority = load(object_priority + x);
+        __m128i pending = nonzero(_mm_xor_si128(object, transparent));
+
+        for (uint index = layers.size(); index--; )
+        {
+            const auto& layer = layers[index];
+
+            __m128i below = _mm_and_si128(pending, _mm_cmpgt_epi16(priority, _mm_set1_epi16(layer.priority)));
+            push(below, object, flag_obj);
+            pending = _mm_andnot_si128(below, pending);
+
+            __m128i color = load(layer.data + x);
+            __m128i flag  = _mm_set1_epi16(layer.flag);
+            __m128i mask  = _mm_andnot_si128(
+                _mm_cmpeq_epi16(color, transparent),
+                nonzero(_mm_and_si128(layer_enabled, flag)));
+
+            push(mask, color, flag);
+        }
+        push(pending, object, flag_obj);
+
+        __m128i color = upper;
+
+        if (blending)
+        {
+            __m128i is_upper = nonzero(_mm_and_si128(upper_flag, bld_upper));
+            __m128i is_lower = nonzero(_mm_and_si128(lower_flag, bld_lower));
+            __m128i window_blend = load(blend + x);
+
+            switch (BlendMode(bldcnt.mode))
+            {
+            case BlendMode::Alpha:
+                color = select(
+                    _mm_and_si128(window_blend, _mm_and_si128(is_upper, is_lower)),
+                    blendAlpha(upper, lower, eva, evb), color);
+                break;
+
+            case BlendMode::White:
+                color = select(_mm_and_si128(window_blend, is_upper), blendWhite(upper, evy), color);
+                break;
+
+            case BlendMode::Black:
+                color = select(_mm_and_si128(window_blend, is_upper), blendBlack(upper, evy), color);
+                break;
+
+            default:
+                break;
+            }
+
+            __m128i alpha = _mm_and_si128(
+                _mm_and_si128(load(object_alpha + x), is_lower),
+                _mm_cmpeq_epi16(upper_flag, flag_obj));
+
+            color = select(alpha, blendAlpha(upper, lower, eva, evb), color);
+        }
+        _mm_store_si128(reinterpret_cast<__m128i*>(result + x), color);
+    }
+
+    for (auto [x, color] : shell::enumerate(video_ctx.scanline(vcount)))
+    {
+        color = Color::toArgb(result[x]);
+    }
+}
+
+#endif
@@ -16,6 +16,10 @@ inline constexpr uint kTileBlockBytes   = 0x4000;
 inline constexpr uint kFrameBytes       = 0xA000;
 inline constexpr uint kObjectBase       = 0x1'0000;
 inline constexpr uint kObjectBaseBitmap = 0x1'4000;
+inline constexpr uint kHDrawCycles      = 1006;
+inline constexpr uint kHBlankCycles     = 226;
+inline constexpr uint kLineCycles       = kHDrawCycles + kHBlankCycles;
+inline constexpr uint kLines            = 228;
 
 enum class ColorMode
 {
@@ -89,9 +89,9 @@ void DisplayStatus::write(uint index, u8 byte)
     }
 }
 
-VerticalCounter& VerticalCounter::operator++()
+VerticalCounter& VerticalCounter::operator=(uint line)
 {
-    data = (data + 1) % 228;
+    data = line;
     return *this;
 }
 
@@ -42,7 +42,7 @@ class DisplayStatus : public Register<u16, 0xFF38>
 class VerticalCounter : public RegisterR<u16>
 {
 public:
-    VerticalCounter& operator++();
+    VerticalCounter& operator=(uint line);
     operator u16() const;
 };
 
@@ -168,6 +168,8 @@ class BlendAlpha : public Register<u16, 0x1F1F>
     u16 blendAlpha(u16 a, u16 b) const;
 
 private:
+    friend class Ppu;
+
     uint eva = 0;
     uint evb = 0;
 };
@@ -181,5 +183,7 @@ class BlendFade : public RegisterW<u16, 0x001F>
     u16 blendBlack(u16 a) const;
 
 private:
+    friend class Ppu;
+
     uint evy = 0;
 };
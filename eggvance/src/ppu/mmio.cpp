@@ -0,0 +1,53 @@
+#include "ppu.h"
+
+#include "arm/constants.h"
+
+void Ppu::writeIo(u32 addr, u8 byte)
+{
+    catchUp();
+
+    if (renderer)
+        renderer->write(addr, byte);
+
+    io[addr] = byte;
+
+    switch (addr)
+    {
+    SHELL_CASE02(uint(Io::DisplayControl), dispcnt.write(kIndex, byte));
+    SHELL_CASE02(uint(Io::GreenSwap),      greenswap.write(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg0Control),     backgrounds[0].control.write(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg1Control),     backgrounds[1].control.write(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg2Control),     backgrounds[2].control.write(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg3Control),     backgrounds[3].control.write(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg0HorOffset),   backgrounds[0].offset.writeX(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg0VerOffset),   backgrounds[0].offset.writeY(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg1HorOffset),   backgrounds[1].offset.writeX(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg1VerOffset),   backgrounds[1].offset.writeY(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg2HorOffset),   backgrounds[2].offset.writeX(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg2VerOffset),   backgrounds[2].offset.writeY(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg3HorOffset),   backgrounds[3].offset.writeX(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg3VerOffset),   backgrounds[3].offset.writeY(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg2ParameterA),  backgrounds[2].matrix.writeA(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg2ParameterB),  backgrounds[2].matrix.writeB(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg2ParameterC),  backgrounds[2].matrix.writeC(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg2ParameterD),  backgrounds[2].matrix.writeD(kIndex, byte));
+    SHELL_CASE04(uint(Io::Bg2ReferenceX),  backgrounds[2].matrix.writeX(kIndex, byte));
+    SHELL_CASE04(uint(Io::Bg2ReferenceY),  backgrounds[2].matrix.writeY(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg3ParameterA),  backgrounds[3].matrix.writeA(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg3ParameterB),  backgrounds[3].matrix.writeB(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg3ParameterC),  backgrounds[3].matrix.writeC(kIndex, byte));
+    SHELL_CASE02(uint(Io::Bg3ParameterD),  backgrounds[3].matrix.writeD(kIndex, byte));
+    SHELL_CASE04(uint(Io::Bg3ReferenceX),  backgrounds[3].matrix.writeX(kIndex, byte));
+    SHELL_CASE04(uint(Io::Bg3ReferenceY),  backgrounds[3].matrix.writeY(kIndex, byte));
+    SHELL_CASE02(uint(Io::Window0Hor),     winh[0].write(kIndex, byte));
+    SHELL_CASE02(uint(Io::Window1Hor),     winh[1].write(kIndex, byte));
+    SHELL_CASE02(uint(Io::Window0Ver),     winv[0].write(kIndex, byte));
+    SHELL_CASE02(uint(Io::Window1Ver),     winv[1].write(kIndex, byte));
+    SHELL_CASE02(uint(Io::WindowInside),   winin.write(kIndex, byte));
+    SHELL_CASE02(uint(Io::WindowOutside),  winout.write(kIndex, byte));
+    SHELL_CASE02(uint(Io::Mosaic),         mosaic.write(kIndex, byte));
+    SHELL_CASE02(uint(Io::BlendControl),   bldcnt.write(kIndex, byte));
+    SHELL_CASE02(uint(Io::BlendAlpha),     bldalpha.write(kIndex, byte));
+    SHELL_CASE02(uint(Io::BlendFade),      bldfade.write(kIndex, byte));
+    }
+}
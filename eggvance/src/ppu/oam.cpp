@@ -1,9 +1,16 @@
 #include "oam.h"
 
+#include <algorithm>
 #include <shell/macros.h>
 
 #include "base/bit.h"
 
+Oam::Oam()
+{
+    for (uint index = 0; index < entries.size(); ++index)
+        updateBands(index);
+}
+
 void Oam::writeHalf(u32 addr, u16 half)
 {
     addr &= ~0x1;
@@ -14,8 +21,8 @@ void Oam::writeHalf(u32 addr, u16 half)
 
     switch (addr & 0x6)
     {
-    case 0: entry.writeAttr0(half); break;
-    case 2: entry.writeAttr1(half); break;
+    case 0: entry.writeAttr0(half); updateBands(addr >> 3); break;
+    case 2: entry.writeAttr1(half); updateBands(addr >> 3); break;
     case 4: entry.writeAttr2(half); break;
     case 6: matrix.write(addr >> 3, half); break;
 
@@ -25,6 +32,7 @@ void Oam::writeHalf(u32 addr, u16 half)
     }
 
     writeFast<u16>(addr, half);
+    generation++;
 }
 
 void Oam::writeWord(u32 addr, u32 word)
@@ -34,3 +42,22 @@ void Oam::writeWord(u32 addr, u32 word)
     writeHalf(addr + 0, bit::seq< 0, 16>(word));
     writeHalf(addr + 2, bit::seq<16, 16>(word));
 }
+
+void Oam::updateBands(uint index)
+{
+    const auto& entry = entries[index];
+
+    u64 mask = 1ULL << (index % 64);
+
+    for (auto& band : bands)
+        band[index / 64] &= ~mask;
+
+    if (entry.disabled)
+        return;
+
+    int begin = std::max(entry.origin.y, 0);
+    int end   = std::min(entry.origin.y + entry.screen_size.y, static_cast<int>(kScreenH));
+
+    for (int band = begin / kBandLines; band * kBandLines < end; ++band)
+        bands[band][index / 64] |= mask;
+}
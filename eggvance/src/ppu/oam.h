@@ -4,15 +4,26 @@
 
 #include "matrix.h"
 #include "oamentry.h"
+#include "base/constants.h"
 #include "base/ram.h"
 
 class Oam : public Ram<1024>
 {
 public:
+    static constexpr auto kBandLines = 8;
+    static constexpr auto kBands     = kScreenH / kBandLines;
+
+    Oam();
+
     void writeByte(u32 addr, u8  byte) = delete;
     void writeHalf(u32 addr, u16 half);
     void writeWord(u32 addr, u32 word);
 
     shell::array<OamEntry, 128> entries = {};
     shell::array<RotationScalingMatrix, 32> matrices = {};
+    shell::array<u64, kBands, 2> bands = {};
+    u32 generation = 0;
+
+private:
+    void updateBands(uint index);
 };
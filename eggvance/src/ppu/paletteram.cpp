@@ -10,6 +10,18 @@ void PaletteRam::writeByte(u32 addr, u8 byte)
     writeHalf(addr, byte * 0x0101);
 }
 
+void PaletteRam::writeHalf(u32 addr, u16 half)
+{
+    Ram::writeHalf(addr, half);
+    generation++;
+}
+
+void PaletteRam::writeWord(u32 addr, u32 word)
+{
+    Ram::writeWord(addr, word);
+    generation++;
+}
+
 u16 PaletteRam::colorFg(uint index, uint bank) const
 {
     return index == 0
@@ -5,11 +5,15 @@
 class PaletteRam : public Ram<1024>
 {
 public:
-    void writeByte(u32 addr, u8 byte);
+    void writeByte(u32 addr, u8  byte);
+    void writeHalf(u32 addr, u16 half);
+    void writeWord(u32 addr, u32 word);
 
     u16 colorFg(uint index, uint bank = 0) const;
     u16 colorBg(uint index, uint bank = 0) const;
     u16 colorFgOpaque(uint index, uint bank = 0) const;
     u16 colorBgOpaque(uint index, uint bank = 0) const;
     u16 backdrop() const;
+
+    u32 generation = 0;
 };
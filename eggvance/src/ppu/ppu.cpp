@@ -1,5 +1,7 @@
 #include "ppu.h"
 
+#include <algorithm>
+
 #include "arm/arm.h"
 #include "base/bit.h"
 #include "base/config.h"
@@ -8,22 +10,49 @@
 
 void Ppu::init()
 {
-    events.hblank = [this](u64 late)
-    {
-        hblank(late);
-    };
+    events.hblank.bind<&Ppu::hblank>(this);
+    events.hblank_end.bind<&Ppu::hblankEnd>(this);
+
+    origin = scheduler.now();
+
+    if (config.render_thread)
+        renderer = std::make_unique<Renderer>();
 
-    events.hblank_end = [this](u64 late)
+    if (!renderer)
+        lines_due = origin + kHDrawCycles;
+
+    schedule(origin);
+}
+
+void Ppu::sync()
+{
+    sync(scheduler.now());
+}
+
+void Ppu::schedule()
+{
+    for (Event* event : { &events.hblank, &events.hblank_end })
     {
-        hblankEnd(late);
-    };
+        if (event->when > scheduler.now())
+            scheduler.remove(*event);
+    }
 
-    scheduler.insert(events.hblank, 1006);
+    if (!events.hblank.isScheduled() && !events.hblank_end.isScheduled())
+        schedule(scheduler.now());
+}
+
+u64 Ppu::nextTransition() const
+{
+    u64 cycle = (scheduler.now() - origin) % kLineCycles;
+
+    return scheduler.now() - cycle + (cycle < kHDrawCycles ? kHDrawCycles : kLineCycles);
 }
 
 void Ppu::hblank(u64 late)
 {
-    dispstat.hblank = true;
+    u64 time = scheduler.now() - late;
+
+    sync(time);
 
     if (dispstat.hblank_irq)
     {
@@ -32,10 +61,13 @@ void Ppu::hblank(u64 late)
 
     if (vcount < 160)
     {
-        render();
+        if (renderer)
+        {
+            renderer->render(*this, vcount);
 
-        backgrounds[2].matrix.hblank();
-        backgrounds[3].matrix.hblank();
+            backgrounds[2].matrix.hblank();
+            backgrounds[3].matrix.hblank();
+        }
 
         dma.broadcast(Dma::Event::HBlank);
     }
@@ -45,17 +77,15 @@ void Ppu::hblank(u64 late)
         dma.broadcast(Dma::Event::Hdma);
     }
 
-    scheduler.insert(events.hblank_end, 226 - late);
+    schedule(time);
 }
 
 void Ppu::hblankEnd(u64 late)
 {
-    ++vcount;
+    u64 time = scheduler.now() - late;
 
-    dispstat.hblank = false;
-    dispstat.vblank = vcount >= 160 && vcount < 227;
+    sync(time);
 
-    dispstat.vmatch = vcount == dispstat.vcompare;
     if (dispstat.vmatch && dispstat.vmatch_irq)
     {
         arm.raise(Irq::VMatch, late);
@@ -63,11 +93,24 @@ void Ppu::hblankEnd(u64 late)
 
     if (vcount == 160)
     {
+        catchUp();
+
+        if (renderer)
+        {
+            renderer->vblank(*this);
+            renderer->wait(*this);
+        }
         video_ctx.renderFrame();
 
         backgrounds[2].matrix.vblank();
         backgrounds[3].matrix.vblank();
 
+        if (!renderer)
+        {
+            lines_begin = 0;
+            lines_due = time + (kLines - 160) * kLineCycles + kHDrawCycles;
+        }
+
         if (dispstat.vblank_irq)
         {
             arm.raise(Irq::VBlank, late);
@@ -75,5 +118,84 @@ void Ppu::hblankEnd(u64 late)
         dma.broadcast(Dma::Event::VBlank);
     }
 
-    scheduler.insert(events.hblank, 1006 - late);
+    schedule(time);
+}
+
+void Ppu::renderLines()
+{
+    uint line = vcount;
+
+    for (; lines_begin < 160 && lines_due <= scheduler.now(); ++lines_begin)
+    {
+        vcount = lines_begin;
+
+        render();
+
+        backgrounds[2].matrix.hblank();
+        backgrounds[3].matrix.hblank();
+
+        lines_due += kLineCycles;
+    }
+    vcount = line;
+
+    if (lines_begin == 160)
+        lines_due = std::numeric_limits<u64>::max();
+}
+
+void Ppu::sync(u64 time)
+{
+    u64 cycle = (time - origin) % (kLines * kLineCycles);
+
+    vcount = cycle / kLineCycles;
+
+    dispstat.hblank = cycle % kLineCycles >= kHDrawCycles;
+    dispstat.vblank = vcount >= 160 && vcount < 227;
+    dispstat.vmatch = vcount == dispstat.vcompare;
+}
+
+void Ppu::schedule(u64 time)
+{
+    u64 start = time - (time - origin) % kLineCycles;
+    uint line = (time - origin) / kLineCycles % kLines;
+
+    // Events serviced late can leave time more than a line behind now
+    const auto in = [](u64 when) -> u64
+    {
+        return std::max<s64>(static_cast<s64>(when - scheduler.now()), 1);
+    };
+
+    for (uint x = 0; x <= kLines; ++x)
+    {
+        if (start > time && isObservableLine(line))
+        {
+            scheduler.insert(events.hblank_end, in(start));
+            return;
+        }
+
+        if (start + kHDrawCycles > time && isObservableHBlank(line))
+        {
+            scheduler.insert(events.hblank, in(start + kHDrawCycles));
+            return;
+        }
+
+        start += kLineCycles;
+        line = (line + 1) % kLines;
+    }
+    SHELL_UNREACHABLE;
+}
+
+bool Ppu::isObservableHBlank(uint line) const
+{
+    if (dispstat.hblank_irq)
+        return true;
+
+    if (line < 160 && (renderer || dma.waits(Dma::Event::HBlank)))
+        return true;
+
+    return line > 1 && line < 162 && dma.waits(Dma::Event::Hdma);
+}
+
+bool Ppu::isObservableLine(uint line) const
+{
+    return line == 160 || (line == dispstat.vcompare && dispstat.vmatch_irq);
 }
@@ -1,18 +1,37 @@
 #pragma once
 
+#include <limits>
 #include <shell/buffer.h>
+#include <shell/macros.h>
 
 #include "background.h"
 #include "layers.h"
 #include "oam.h"
 #include "paletteram.h"
+#include "renderer.h"
+#include "simd.h"
 #include "videoram.h"
 #include "scheduler/event.h"
+#include "scheduler/scheduler.h"
 
 class Ppu
 {
 public:
+    friend class ComposeTest;
+    friend class ObjectsBenchmark;
+    friend class Renderer;
+
     void init();
+    void sync();
+    void schedule();
+    u64 nextTransition() const;
+    void writeIo(u32 addr, u8 byte);
+
+    SHELL_INLINE void catchUp()
+    {
+        if (scheduler.now() >= lines_due)
+            renderLines();
+    }
 
     DisplayControl dispcnt;
     Register<u16, 0x0001> greenswap;
@@ -34,6 +53,9 @@ class Ppu
     VideoRam vram = {};
     Oam oam = {};
 
+    u64 lines_rendered = 0;
+    u64 lines_reused = 0;
+
 private:
     struct ComposeLayer
     {
@@ -46,14 +68,32 @@ class Ppu
         uint color = 0;
     };
 
+    struct LineSignature
+    {
+        shell::array<u8, 0x60> io = {};
+        shell::array<TransformationMatrix, 2> matrices;
+        u32 vram = 0;
+        u32 pram = 0;
+        u32 oam = 0;
+        uint layers = 0;
+        uint color_correct = false;
+        uint valid = false;
+    };
+
     using ComposeLayers    = std::tuple<ComposeLayer, ComposeLayer>;
     using BackgroundRender = void(Ppu::*)(Background&);
     using BackgroundLayers = shell::FixedBuffer<BackgroundLayer, 4>;
 
     void hblank(u64 late);
     void hblankEnd(u64 late);
+    void sync(u64 time);
+    void schedule(u64 time);
+    bool isObservableHBlank(uint line) const;
+    bool isObservableLine(uint line) const;
 
     void render();
+    void renderLines();
+    bool reuseLine();
     void renderBackground(BackgroundRender render, Background& background);
     void renderObjects();
 
@@ -65,7 +105,7 @@ class Ppu
     void renderBackground4(Background& background);
     void renderBackground5(Background& background);
 
-    void compose(uint possible);
+    void compose(uint possible, bool simd = SIMD_ENABLED);
     template<bool kObjects>
     void composeNN(const BackgroundLayers& layers);
     template<bool kObjects, uint kWindows>
@@ -74,6 +114,9 @@ class Ppu
     void composeBN(const BackgroundLayers& layers);
     template<bool kObjects, uint kBlendMode, uint kWindows>
     void composeBW(const BackgroundLayers& layers);
+    #if SIMD_ENABLED
+    void composeSimd(const BackgroundLayers& layers, bool windowed, uint windows);
+    #endif
 
     template<uint kWindows>
     const Window& activeWindow(uint x) const;
@@ -83,10 +126,19 @@ class Ppu
     template<bool kObjects>
     ComposeLayers findUpperLayers(const BackgroundLayers& layers, uint x, uint enabled = 0xFFFF'FFFF);
 
+    uint buffers_stale = false;
     uint objects_exist = false;
     uint objects_alpha = false;
     ScanlineBuffer<ObjectLayer> objects;
 
+    shell::array<u8, 0x60> io = {};
+    shell::array<LineSignature, kScreenH> signatures = {};
+
+    u64 origin = 0;
+    uint lines_begin = 0;
+    u64 lines_due = std::numeric_limits<u64>::max();
+    std::unique_ptr<Renderer> renderer;
+
     struct Events
     {
         Event hblank;
@@ -1,16 +1,25 @@
 #include "ppu.h"
 
+#include <cstring>
+#include <type_traits>
 #include <shell/macros.h>
 #include <shell/operators.h>
 
 #include "color.h"
 #include "mapentry.h"
 #include "matrix.h"
+#include "base/bit.h"
 #include "base/config.h"
 #include "frontend/videocontext.h"
 
 void Ppu::render()
 {
+    if (reuseLine())
+    {
+        buffers_stale = true;
+        return;
+    }
+
     if (dispcnt.blank)
     {
         auto& scanline = video_ctx.scanline(vcount);
@@ -78,6 +87,43 @@ void Ppu::render()
         compose(uint(Layer::Flag::Bg2));
         break;
     }
+    buffers_stale = false;
+}
+
+bool Ppu::reuseLine()
+{
+    static_assert(std::has_unique_object_representations_v<LineSignature>);
+
+    const uint boundary = dispcnt.isBitmap() ? kObjectBaseBitmap : kObjectBase;
+
+    LineSignature signature;
+    signature.io = io;
+    signature.matrices = { backgrounds[2].matrix, backgrounds[3].matrix };
+    signature.pram = pram.generation;
+    signature.layers = config.video_layers;
+    signature.color_correct = config.color_correct;
+    signature.valid = true;
+
+    if (dispcnt.enabled & 0xF)
+        signature.vram += vram.generation(0, boundary);
+
+    if (dispcnt.enabled & Layer::Flag::Obj)
+    {
+        signature.vram += vram.generation(boundary, vram.size());
+        signature.oam = oam.generation;
+    }
+
+    lines_rendered++;
+
+    auto& previous = signatures[vcount];
+    if (std::memcmp(&previous, &signature, sizeof(LineSignature)) == 0 && !mosaic.bgs.isMosaicY())
+    {
+        lines_reused++;
+        return true;
+    }
+
+    previous = signature;
+    return false;
 }
 
 void Ppu::renderBackground(BackgroundRender render, Background& background)
@@ -85,13 +131,13 @@ void Ppu::renderBackground(BackgroundRender render, Background& background)
     if ((dispcnt.enabled & (1 << background.id)) == 0)
         return;
 
-    if (background.control.mosaic && mosaic.bgs.isMosaicY() && !mosaic.bgs.isDominantY(vcount))
+    if (background.control.mosaic && mosaic.bgs.isMosaicY() && !mosaic.bgs.isDominantY(vcount) && !buffers_stale)
     {
         background.buffer.flip();
     }
     else
     {
-        std::invoke(render, this, background);
+        (this->*render)(background);
 
         if (background.control.mosaic && mosaic.bgs.isMosaicX())
         {
@@ -127,11 +173,11 @@ void Ppu::renderBackground0(Background& background)
             u32 addr = background.control.tile_block + kTileBytes[kColorMode] * entry.tile;
             if (addr < kObjectBase)
             {
+                const u8* row = vram.tile<kColorMode>(addr) + kTileSize * (pixel.y ^ entry.flip.y);
+
                 for (; pixel.x < kTileSize; ++pixel.x)
                 {
-                    uint index = kColorMode == ColorMode::C16x16
-                        ? vram.index16x16(addr, pixel ^ entry.flip)
-                        : vram.index256x1(addr, pixel ^ entry.flip);
+                    uint index = row[pixel.x ^ entry.flip.x];
 
                     background.buffer[x] = kColorMode == ColorMode::C16x16
                         ? pram.colorBg(index, entry.bank)
@@ -270,91 +316,98 @@ void Ppu::renderObjects()
 {
     s64 cycles = dispcnt.oam_free ? 954 : 1210;
 
-    for (const auto& entry : oam.entries)
+    const auto& band = oam.bands[vcount / Oam::kBandLines];
+
+    for (uint word = 0; word < band.size() && cycles > 0; ++word)
     {
-        if (entry.disabled || !entry.isVisible(vcount))
-            continue;
+        for (uint index : bit::iterate(band[word]))
+        {
+            const auto& entry = oam.entries[64 * word + index];
 
-        const auto& origin      = entry.origin;
-        const auto& center      = entry.center;
-        const auto& sprite_size = entry.sprite_size;
-        const auto& screen_size = entry.screen_size;
-        const auto& matrix      = entry.affine ? oam.matrices[entry.matrix] : kIdentityMatrix;
+            if (entry.disabled || !entry.isVisible(vcount))
+                continue;
 
-        uint tile_bytes = entry.tileBytes();
-        uint tiles_row  = entry.tilesPerRow(dispcnt.layout);
-        uint bank       = entry.paletteBank();
+            const auto& origin      = entry.origin;
+            const auto& center      = entry.center;
+            const auto& sprite_size = entry.sprite_size;
+            const auto& screen_size = entry.screen_size;
+            const auto& matrix      = entry.affine ? oam.matrices[entry.matrix] : kIdentityMatrix;
 
-        Point offset(
-            -center.x + origin.x - std::min(origin.x, 0),
-            -center.y + vcount);
+            uint tile_bytes = entry.tileBytes();
+            uint tiles_row  = entry.tilesPerRow(dispcnt.layout);
+            uint bank       = entry.paletteBank();
 
-        uint end = std::min<uint>(origin.x + screen_size.x, kScreenW);
+            Point offset(
+                -center.x + origin.x - std::min(origin.x, 0),
+                -center.y + vcount);
 
-        for (uint x = center.x + offset.x; x < end; ++x, ++offset.x)
-        {
-            auto texel = (matrix * offset) + (sprite_size / 2);
+            uint end = std::min<uint>(origin.x + screen_size.x, kScreenW);
 
-            if (static_cast<uint>(texel.x) >= sprite_size.x ||
-                static_cast<uint>(texel.y) >= sprite_size.y)
-                continue;
+            for (uint x = center.x + offset.x; x < end; ++x, ++offset.x)
+            {
+                auto texel = (matrix * offset) + (sprite_size / 2);
 
-            if (!entry.affine)
-                texel ^= entry.flip;
+                if (static_cast<uint>(texel.x) >= sprite_size.x ||
+                    static_cast<uint>(texel.y) >= sprite_size.y)
+                    continue;
 
-            if (entry.mosaic)
-            {
-                texel.x = mosaic.obj.mosaicX(texel.x);
-                texel.y = mosaic.obj.mosaicY(texel.y);
-            }
+                if (!entry.affine)
+                    texel ^= entry.flip;
 
-            const auto tile  = texel / kTileSize;
-            const auto pixel = texel % kTileSize;
+                if (entry.mosaic)
+                {
+                    texel.x = mosaic.obj.mosaicX(texel.x);
+                    texel.y = mosaic.obj.mosaicY(texel.y);
+                }
 
-            u32 addr = vram.mirror(entry.base_addr + tile_bytes * tile.index2d(tiles_row));
-            if (addr < kObjectBaseBitmap && dispcnt.isBitmap())
-                continue;
+                const auto tile  = texel / kTileSize;
+                const auto pixel = texel % kTileSize;
 
-            auto& object = objects[x];
+                u32 addr = vram.mirror(entry.base_addr + tile_bytes * tile.index2d(tiles_row));
+                if (addr < kObjectBaseBitmap && dispcnt.isBitmap())
+                    continue;
 
-            uint index = vram.index(addr, pixel, entry.color_mode);
+                auto& object = objects[x];
 
-            switch (ObjectMode(entry.object_mode))
-            {
-            case ObjectMode::Normal:
-            case ObjectMode::Alpha:
-                if (entry.priority < object.priority || !object.isOpaque())
+                uint index = vram.index(addr, pixel, entry.color_mode);
+
+                switch (ObjectMode(entry.object_mode))
                 {
+                case ObjectMode::Normal:
+                case ObjectMode::Alpha:
+                    if (entry.priority < object.priority || !object.isOpaque())
+                    {
+                        if (index != 0)
+                        {
+                            object.color  = pram.colorFgOpaque(index, bank);
+                            object.alpha  = entry.object_mode == ObjectMode::Alpha;
+                            objects_exist = true;
+                            objects_alpha |= object.alpha;
+                        }
+                        object.priority = entry.priority;
+                    }
+                    break;
+
+                case ObjectMode::Window:
                     if (index != 0)
                     {
-                        object.color  = pram.colorFgOpaque(index, bank);
-                        object.alpha  = entry.object_mode == ObjectMode::Alpha;
+                        object.window = true;
                         objects_exist = true;
-                        objects_alpha |= object.alpha;
                     }
-                    object.priority = entry.priority;
-                }
-                break;
+                    break;
 
-            case ObjectMode::Window:
-                if (index != 0)
-                {
-                    object.window = true;
-                    objects_exist = true;
-                }
-                break;
+                case ObjectMode::Invalid:
+                    break;
 
-            case ObjectMode::Invalid:
-                break;
+                default:
+                    SHELL_UNREACHABLE;
+                    break;
+                }
+            }
 
-            default:
-                SHELL_UNREACHABLE;
+            cycles -= entry.cycles();
+            if (cycles <= 0)
                 break;
-            }
         }
-
-        cycles -= entry.cycles();
-        if (cycles <= 0)
-            break;
     }
 }
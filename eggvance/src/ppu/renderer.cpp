@@ -0,0 +1,150 @@
+#include "renderer.h"
+
+#include <algorithm>
+
+#include "ppu.h"
+
+Renderer::Renderer()
+    : shadow(std::make_unique<Ppu>())
+{
+    thread = std::thread(&Renderer::run, this);
+}
+
+Renderer::~Renderer()
+{
+    {
+        std::lock_guard lock(mutex);
+        stop = true;
+    }
+    condition.notify_all();
+    thread.join();
+}
+
+void Renderer::write(u32 addr, u8 byte)
+{
+    writes.push_back({ addr, byte });
+}
+
+void Renderer::render(const Ppu& ppu, uint line)
+{
+    push(ppu, line);
+}
+
+void Renderer::vblank(const Ppu& ppu)
+{
+    push(ppu, kVBlank);
+}
+
+void Renderer::wait(Ppu& ppu)
+{
+    std::unique_lock lock(mutex);
+    condition.wait(lock, [this]() { return pending == 0; });
+
+    ppu.lines_rendered += shadow->lines_rendered;
+    ppu.lines_reused += shadow->lines_reused;
+    shadow->lines_rendered = 0;
+    shadow->lines_reused = 0;
+}
+
+void Renderer::push(const Ppu& ppu, uint line)
+{
+    constexpr auto kBlockSize = 1 << VideoRam::kBlockBits;
+
+    Job job;
+    job.line = line;
+    job.writes.swap(writes);
+
+    for (uint block = 0; block < VideoRam::kBlocks; ++block)
+    {
+        if (vram_generations[block] == ppu.vram.generations[block])
+            continue;
+
+        vram_generations[block] = ppu.vram.generations[block];
+
+        const u8* data = ppu.vram.data() + block * kBlockSize;
+        job.vram_blocks.push_back(block);
+        job.vram.insert(job.vram.end(), data, data + kBlockSize);
+    }
+
+    if (pram_generation != ppu.pram.generation)
+    {
+        pram_generation = ppu.pram.generation;
+        job.pram.assign(ppu.pram.begin(), ppu.pram.end());
+    }
+
+    if (oam_generation != ppu.oam.generation)
+    {
+        oam_generation = ppu.oam.generation;
+        job.oam.assign(ppu.oam.begin(), ppu.oam.end());
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        jobs.push_back(std::move(job));
+        pending++;
+    }
+    condition.notify_all();
+}
+
+void Renderer::process(Job& job)
+{
+    constexpr auto kBlockSize = 1 << VideoRam::kBlockBits;
+
+    for (const auto& write : job.writes)
+        shadow->writeIo(write.addr, write.byte);
+
+    for (uint x = 0; x < job.vram_blocks.size(); ++x)
+    {
+        const u8* data = job.vram.data() + x * kBlockSize;
+        std::copy(data, data + kBlockSize, shadow->vram.data() + job.vram_blocks[x] * kBlockSize);
+        shadow->vram.invalidate(job.vram_blocks[x] * kBlockSize, kBlockSize);
+    }
+
+    if (!job.pram.empty())
+    {
+        std::copy(job.pram.begin(), job.pram.end(), shadow->pram.begin());
+        shadow->pram.generation++;
+    }
+
+    for (uint addr = 0; addr < job.oam.size(); addr += 2)
+        shadow->oam.writeHalf(addr, job.oam[addr] | job.oam[addr + 1] << 8);
+
+    if (job.line == kVBlank)
+    {
+        shadow->backgrounds[2].matrix.vblank();
+        shadow->backgrounds[3].matrix.vblank();
+    }
+    else
+    {
+        shadow->vcount = job.line;
+        shadow->render();
+        shadow->backgrounds[2].matrix.hblank();
+        shadow->backgrounds[3].matrix.hblank();
+    }
+}
+
+void Renderer::run()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [this]() { return stop || !jobs.empty(); });
+
+            if (jobs.empty())
+                return;
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        process(job);
+
+        {
+            std::lock_guard lock(mutex);
+            pending--;
+        }
+        condition.notify_all();
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <shell/array.h>
+
+#include "videoram.h"
+#include "base/int.h"
+
+class Ppu;
+
+class Renderer
+{
+public:
+    Renderer();
+    ~Renderer();
+
+    void write(u32 addr, u8 byte);
+    void render(const Ppu& ppu, uint line);
+    void vblank(const Ppu& ppu);
+    void wait(Ppu& ppu);
+
+private:
+    static constexpr uint kVBlank = 0xFFFF'FFFF;
+
+    struct IoWrite
+    {
+        u32 addr = 0;
+        u8 byte = 0;
+    };
+
+    struct Job
+    {
+        uint line = 0;
+        std::vector<IoWrite> writes;
+        std::vector<uint> vram_blocks;
+        std::vector<u8> vram;
+        std::vector<u8> pram;
+        std::vector<u8> oam;
+    };
+
+    void push(const Ppu& ppu, uint line);
+    void process(Job& job);
+    void run();
+
+    std::unique_ptr<Ppu> shadow;
+    std::vector<IoWrite> writes;
+    shell::array<u32, VideoRam::kBlocks> vram_generations = {};
+    u32 pram_generation = 0;
+    u32 oam_generation = 0;
+
+    std::deque<Job> jobs;
+    uint pending = 0;
+    bool stop = false;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::thread thread;
+};
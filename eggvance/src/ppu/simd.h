@@ -0,0 +1,9 @@
+#pragma once
+
+#ifndef SIMD_ENABLED
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_ENABLED 1
+#else
+#define SIMD_ENABLED 0
+#endif
+#endif
@@ -18,24 +18,82 @@ void VideoRam::writeByte(u32 addr, u8 byte)
     if (addr < (ppu.dispcnt.isBitmap() ? kObjectBaseBitmap : kObjectBase))
     {
         writeFast<u16>(addr & ~0x1, byte * 0x0101);
+        markDirty(addr);
     }
 }
 
-uint VideoRam::index16x16(u32 addr, const Point& pixel) const
+void VideoRam::writeHalf(u32 addr, u16 half)
 {
-    u8 data = readFast<u8>(addr + pixel.index2d(kTileSize) / 2);
+    Ram::writeHalf(addr, half);
+    markDirty(mirror(addr));
+}
 
-    return bit::nibble(data, pixel.x & 0x1);
+void VideoRam::writeWord(u32 addr, u32 word)
+{
+    Ram::writeWord(addr, word);
+    markDirty(mirror(addr));
 }
 
-uint VideoRam::index256x1(u32 addr, const Point& pixel) const
+void VideoRam::invalidate(u32 addr, u32 size)
 {
-    return readFast<u8>(addr + pixel.index2d(kTileSize));
+    for (u32 x = addr; x < addr + size; x += kTileBytes[0])
+        markDirty(x);
 }
 
-uint VideoRam::index(u32 addr, const Point& pixel, uint color_mode) const
+u32 VideoRam::generation(u32 begin, u32 end) const
+{
+    u32 sum = 0;
+    for (u32 block = begin >> kBlockBits; block < end >> kBlockBits; ++block)
+        sum += generations[block];
+
+    return sum;
+}
+
+uint VideoRam::index16x16(u32 addr, const Point& pixel)
+{
+    return tile<uint(ColorMode::C16x16)>(addr)[pixel.index2d(kTileSize)];
+}
+
+uint VideoRam::index256x1(u32 addr, const Point& pixel)
+{
+    return tile<uint(ColorMode::C256x1)>(addr)[pixel.index2d(kTileSize)];
+}
+
+uint VideoRam::index(u32 addr, const Point& pixel, uint color_mode)
 {
     return color_mode == ColorMode::C16x16
         ? index16x16(addr, pixel)
         : index256x1(addr, pixel);
 }
+
+template<uint kColorMode>
+void VideoRam::decode(uint index)
+{
+    auto& cache = tiles[kColorMode];
+    cache.dirty[index] = false;
+
+    u32 addr = index * kTileBytes[0];
+
+    for (uint pixel = 0; pixel < kTileSize * kTileSize; ++pixel)
+    {
+        cache.data[index][pixel] = kColorMode == ColorMode::C16x16
+            ? bit::nibble(readFast<u8>(addr + pixel / 2), pixel & 0x1)
+            : readFast<u8>(mirror(addr + pixel));
+    }
+}
+
+template void VideoRam::decode<uint(ColorMode::C16x16)>(uint index);
+template void VideoRam::decode<uint(ColorMode::C256x1)>(uint index);
+
+void VideoRam::markDirty(u32 addr)
+{
+    generations[addr >> kBlockBits]++;
+
+    uint index = addr / kTileBytes[0];
+
+    tiles[0].dirty[index] = true;
+    tiles[1].dirty[index] = true;
+
+    if (index > 0)
+        tiles[1].dirty[index - 1] = true;
+}
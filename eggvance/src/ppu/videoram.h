@@ -1,5 +1,8 @@
 #pragma once
  
+#include <shell/macros.h>
+
+#include "constants.h"
 #include "point.h"
 #include "base/ram.h"
 
@@ -12,9 +15,44 @@ class VideoRamMirror
 class VideoRam : public Ram<96 * 1024, VideoRamMirror>
 {
 public:
-    void writeByte(u32 addr, u8 byte);
+    static constexpr auto kBlockBits = 10;
+    static constexpr auto kBlocks    = 96;
+    static constexpr auto kTiles     = 96 * 1024 / kTileBytes[0];
+
+    void writeByte(u32 addr, u8  byte);
+    void writeHalf(u32 addr, u16 half);
+    void writeWord(u32 addr, u32 word);
+    void invalidate(u32 addr, u32 size);
+    u32 generation(u32 begin, u32 end) const;
+
+    template<uint kColorMode>
+    SHELL_INLINE const u8* tile(u32 addr)
+    {
+        SHELL_ASSERT(addr % kTileBytes[0] == 0);
+
+        uint index = addr / kTileBytes[0];
+        if (tiles[kColorMode].dirty[index])
+            decode<kColorMode>(index);
+
+        return tiles[kColorMode].data[index].data();
+    }
+
+    uint index16x16(u32 addr, const Point& pixel);
+    uint index256x1(u32 addr, const Point& pixel);
+    uint index(u32 addr, const Point& pixel, uint color_mode);
+
+    shell::array<u32, kBlocks> generations = {};
+
+private:
+    struct TileCache
+    {
+        shell::array<u8, kTiles, kTileSize * kTileSize> data = {};
+        shell::array<u8, kTiles> dirty = {};
+    };
+
+    template<uint kColorMode>
+    void decode(uint index);
+    void markDirty(u32 addr);
 
-    uint index16x16(u32 addr, const Point& pixel) const;
-    uint index256x1(u32 addr, const Point& pixel) const;
-    uint index(u32 addr, const Point& pixel, uint color_mode) const;
+    shell::array<TileCache, 2> tiles = {};
 };
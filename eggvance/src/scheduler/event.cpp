@@ -2,12 +2,12 @@
 
 bool Event::operator<(const Event& other) const
 {
-    return when < other.when;
+    return when < other.when || (when == other.when && order < other.order);
 }
 
 bool Event::operator>(const Event& other) const
 {
-    return when > other.when;
+    return when > other.when || (when == other.when && order > other.order);
 }
 
 bool Event::isScheduled() const
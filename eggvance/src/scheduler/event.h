@@ -1,18 +1,20 @@
 #pragma once
 
-#include <functional>
-
-#include "node.h"
 #include "base/int.h"
 
-class Event : public Node<Event>
+class Event
 {
 public:
-    template<typename Function>
-    Event& operator=(Function&& func)
+    using Callback = void(*)(void*, u64);
+
+    template<auto kCallback, typename T>
+    void bind(T* object)
     {
-        callback = std::forward<Function>(func);
-        return *this;
+        context  = object;
+        callback = [](void* context, u64 late)
+        {
+            (static_cast<T*>(context)->*kCallback)(late);
+        };
     }
 
     bool operator<(const Event& other) const;
@@ -20,5 +22,8 @@ class Event : public Node<Event>
     bool isScheduled() const;
 
     u64 when = 0;
-    std::function<void(u64)> callback;
+    u64 order = 0;
+    uint index = 0;
+    void* context = nullptr;
+    Callback callback = nullptr;
 };
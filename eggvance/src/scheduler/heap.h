@@ -0,0 +1,105 @@
+#pragma once
+
+#include <utility>
+#include <shell/array.h>
+#include <shell/macros.h>
+
+#include "base/int.h"
+
+template<typename T, uint kSize>
+class Heap
+{
+public:
+    bool isEmpty() const
+    {
+        return size == 0;
+    }
+
+    bool isFull() const
+    {
+        return size == kSize;
+    }
+
+    T& top() const
+    {
+        SHELL_ASSERT(size);
+
+        return *data[0];
+    }
+
+    void insert(T& item)
+    {
+        SHELL_ASSERT(size < kSize);
+
+        item.index = size++;
+        data[item.index] = &item;
+
+        up(item.index);
+    }
+
+    void remove(T& item)
+    {
+        SHELL_ASSERT(item.index < size);
+        SHELL_ASSERT(data[item.index] == &item);
+
+        uint index = item.index;
+        if (index == --size)
+            return;
+
+        data[index] = data[size];
+        data[index]->index = index;
+
+        up(index);
+        down(index);
+    }
+
+    T& pop()
+    {
+        T& item = top();
+        remove(item);
+        return item;
+    }
+
+private:
+    void swap(uint a, uint b)
+    {
+        std::swap(data[a], data[b]);
+        data[a]->index = a;
+        data[b]->index = b;
+    }
+
+    void up(uint index)
+    {
+        while (index > 0)
+        {
+            uint parent = (index - 1) / 2;
+            if (!(*data[index] < *data[parent]))
+                break;
+
+            swap(index, parent);
+            index = parent;
+        }
+    }
+
+    void down(uint index)
+    {
+        while (true)
+        {
+            uint child = 2 * index + 1;
+            if (child >= size)
+                break;
+
+            if (child + 1 < size && *data[child + 1] < *data[child])
+                child++;
+
+            if (!(*data[child] < *data[index]))
+                break;
+
+            swap(index, child);
+            index = child;
+        }
+    }
+
+    uint size = 0;
+    shell::array<T*, kSize> data = {};
+};
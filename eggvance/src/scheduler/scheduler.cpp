@@ -1,47 +1,59 @@
 #include "scheduler.h"
 
-#include <limits>
+#include <shell/errors.h>
 
 Scheduler::Scheduler()
 {
-    next = std::numeric_limits<u64>::max();
-
-    infinity.when = next;
-    infinity = [](u64 late) { SHELL_UNREACHABLE; };
-
-    list.setHead(infinity);
+    update(0);
 }
 
-void Scheduler::run(u64 cycles)
+void Scheduler::process()
 {
-    now += cycles;
-
-    while (now >= next)
+    while (countdown <= 0 && !heap.isEmpty())
     {
-        Event& event = list.pop();
+        u64 now = this->now();
+
+        Event& event = heap.pop();
         event.when = 0;
-        event.callback(now - next);
+        event.callback(event.context, now - next);
 
-        next = list.head->when;
+        update(now);
     }
 }
 
+void Scheduler::update(u64 now)
+{
+    next = heap.isEmpty()
+        ? now + kIdle
+        : heap.top().when;
+
+    countdown = next - now;
+}
+
 void Scheduler::insert(Event& event, u64 in)
 {
     SHELL_ASSERT(event.when == 0);
     SHELL_ASSERT(static_cast<s64>(in) > 0);
 
+    if (heap.isFull())
+        throw shell::Error("Cannot schedule more than {} events", kEvents);
+
+    u64 now = this->now();
+
     event.when = now + in;
-    list.insert(event);
-    next = list.head->when;
+    event.order = order++;
+    heap.insert(event);
+    update(now);
 }
 
 void Scheduler::remove(Event& event)
 {
     if (event.when)
     {
+        u64 now = this->now();
+
         event.when = 0;
-        list.remove(event);
-        next = list.head->when;
+        heap.remove(event);
+        update(now);
     }
 }
@@ -1,23 +1,44 @@
 #pragma once
 
-#include "circularlist.h"
+#include <shell/macros.h>
+
 #include "event.h"
+#include "heap.h"
 
-class Scheduler
+class alignas(64) Scheduler
 {
 public:
     Scheduler();
 
-    void run(u64 cycles);
+    SHELL_INLINE void run(u64 cycles)
+    {
+        countdown -= static_cast<s64>(cycles);
+
+        if (countdown <= 0)
+            process();
+    }
+
+    SHELL_INLINE u64 now() const
+    {
+        return next - countdown;
+    }
+
     void insert(Event& event, u64 in);
     void remove(Event& event);
 
-    u64 now  = 0;
+    // Cycles left until next. Ticks only decrement it, now is derived.
+    s64 countdown = 0;
     u64 next = 0;
 
 private:
-    Event infinity;
-    CircularList<Event> list;
+    static constexpr auto kEvents = 32;
+    static constexpr auto kIdle = u64(1) << 62;
+
+    void process();
+    void update(u64 now);
+
+    u64 order = 0;
+    Heap<Event, kEvents> heap;
 };
 
 inline Scheduler scheduler;
@@ -9,27 +9,8 @@ inline constexpr auto kOverflow = 0x1'0000;
 TimerChannel::TimerChannel(uint id)
     : id(id), count(*this), control(*this)
 {
-    events.run = [this](u64 late)
-    {
-        run();
-        schedule();
-    };
-
-    events.start = [this](u64 late)
-    {
-        if (!control.enabled)
-            return;
-
-        since    = scheduler.now - late;
-        counter  = 0;
-        initial  = count.initial;
-        overflow = control.prescaler * (kOverflow - initial);
-
-        if (control.runnable())
-            run(late);
-
-        schedule();
-    };
+    events.run.bind<&TimerChannel::onRun>(this);
+    events.start.bind<&TimerChannel::onStart>(this);
 }
 
 void TimerChannel::start()
@@ -70,12 +51,34 @@ void TimerChannel::run(u64 ticks)
     }
 
     count.counter = counter / control.prescaler + initial;
-    since = scheduler.now;
+    since = scheduler.now();
 }
 
 void TimerChannel::run()
 {
-    run(scheduler.now - since);
+    run(scheduler.now() - since);
+}
+
+void TimerChannel::onRun(u64 late)
+{
+    run();
+    schedule();
+}
+
+void TimerChannel::onStart(u64 late)
+{
+    if (!control.enabled)
+        return;
+
+    since    = scheduler.now() - late;
+    counter  = 0;
+    initial  = count.initial;
+    overflow = control.prescaler * (kOverflow - initial);
+
+    if (control.runnable())
+        run(late);
+
+    schedule();
 }
 
 void TimerChannel::schedule()
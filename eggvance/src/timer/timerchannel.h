@@ -20,6 +20,8 @@ class TimerChannel
 
 private:
     void run(u64 ticks);
+    void onRun(u64 late);
+    void onStart(u64 late);
 
     struct Events
     {
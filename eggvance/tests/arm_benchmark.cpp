@@ -0,0 +1,202 @@
+#include <chrono>
+#include <shell/format.h>
+#include <shell/operators.h>
+#include <shell/ranges.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "arm/arm.h"
+#include "ppu/constants.h"
+
+// Counts host L1 data cache read misses where the kernel exposes hardware
+// counters. Reports nothing on other platforms or without a PMU.
+class CacheMisses
+{
+public:
+    CacheMisses()
+    {
+        #if defined(__linux__)
+        perf_event_attr attr = {};
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_L1D
+            | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        #endif
+    }
+
+    ~CacheMisses()
+    {
+        #if defined(__linux__)
+        if (fd >= 0)
+            close(fd);
+        #endif
+    }
+
+    void start()
+    {
+        #if defined(__linux__)
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+        #endif
+    }
+
+    bool stop(u64& misses)
+    {
+        #if defined(__linux__)
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            return read(fd, &misses, sizeof(misses)) == sizeof(misses);
+        }
+        #endif
+        return false;
+    }
+
+private:
+    int fd = -1;
+};
+
+class ArmBenchmark
+{
+public:
+    static void loop(uint frames)
+    {
+        static constexpr u16 kLoop[] =
+        {
+            0x3001,  // adds r0, 1
+            0x6811,  // ldr  r1, [r2]
+            0x6051,  // str  r1, [r2, 4]
+            0x0083,  // lsls r3, r0, 2
+            0x4283,  // cmp  r3, r0
+            0xE7F9   // b    loop
+        };
+
+        for (auto [index, instr] : shell::enumerate(kLoop))
+            arm.iwram->writeFast<u16>(2 * index, instr);
+
+        arm.regs[2] = 0x0300'1000;
+
+        run("loop", 0x0300'0000, frames);
+    }
+
+    // Data processing heavy loop. Almost every instruction sets flags,
+    // but only the cmp result is read by a condition.
+    static void alu(uint frames)
+    {
+        static constexpr u16 kLoop[] =
+        {
+            0x3001,  // adds r0, 1
+            0x00C1,  // lsls r1, r0, 3
+            0x4041,  // eors r1, r0
+            0x1A0A,  // subs r2, r1, r0
+            0x400A,  // ands r2, r1
+            0x1853,  // adds r3, r2, r1
+            0x089C,  // lsrs r4, r3, 2
+            0x4314,  // orrs r4, r2
+            0x4284,  // cmp  r4, r0
+            0xD1F5,  // bne  loop
+            0xE7F4   // b    loop
+        };
+
+        for (auto [index, instr] : shell::enumerate(kLoop))
+            arm.iwram->writeFast<u16>(0x2000 + 2 * index, instr);
+
+        arm.regs[0] = 0;
+
+        run("alu", 0x0300'2000, frames);
+    }
+
+    // Spreads short blocks over 128 KiB of EWRAM and walks another 128 KiB
+    // of data. Guest memory and block cache entries exceed the host L1 and
+    // compete with the CPU state for it.
+    static void spread(uint frames)
+    {
+        static constexpr uint kChunks = 2048;
+        static constexpr uint kStride = 64;
+
+        static constexpr u16 kChunk[] =
+        {
+            0x3001,  // adds r0, 1
+            0x58B1,  // ldr  r1, [r6, r2]
+            0x1809,  // adds r1, r1, r0
+            0x50B1,  // str  r1, [r6, r2]
+            0x3240,  // adds r2, 64
+            0x402A   // ands r2, r5
+        };
+
+        for (uint chunk = 0; chunk < kChunks; ++chunk)
+        {
+            u32 addr = chunk * kStride;
+
+            for (auto [index, instr] : shell::enumerate(kChunk))
+                arm.ewram->writeFast<u16>(addr + 2 * index, instr);
+
+            u32 next = addr + 2 * std::size(kChunk);
+            if (chunk + 1 < kChunks)
+                arm.ewram->writeFast<u16>(next, 0xE000 | (((kStride - (next - addr) - 4) >> 1) & 0x7FF));
+            else
+                arm.ewram->writeFast<u16>(next, 0x4738);  // bx r7
+        }
+
+        arm.regs[2] = 0;
+        arm.regs[5] = 0x1'FFFF;
+        arm.regs[6] = 0x0202'0000;
+        arm.regs[7] = 0x0200'0001;
+
+        run("spread", 0x0200'0000, frames);
+    }
+
+private:
+    static void run(const char* name, u32 pc, uint frames)
+    {
+        using Clock = std::chrono::high_resolution_clock;
+
+        arm.init();
+        arm.pc = pc;
+        arm.cpsr.t = 1;
+        arm.state |= Arm::State::Thumb;
+        arm.flushHalf();
+        arm.instructions = 0;
+
+        CacheMisses counter;
+        counter.start();
+
+        const auto begin = Clock::now();
+
+        for (uint x = 0; x < frames; ++x)
+            arm.run(kLineCycles * kLines);
+
+        const auto seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+        shell::print("{}: {} frames in {:.2f} s - {:.1f} MIPS",
+            name, frames, seconds, arm.instructions / seconds / 1'000'000);
+
+        if (u64 misses; counter.stop(misses))
+            shell::print(" - {:.2f} L1D misses per 1000 instructions", 1000.0 * misses / arm.instructions);
+
+        shell::print("\n");
+    }
+};
+
+int main()
+{
+    ArmBenchmark::loop(2000);
+    ArmBenchmark::alu(2000);
+    ArmBenchmark::spread(2000);
+
+    return 0;
+}
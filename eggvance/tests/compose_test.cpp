@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <random>
+#include <shell/format.h>
+
+#include "base/config.h"
+#include "frontend/videocontext.h"
+#include "ppu/color.h"
+#include "ppu/ppu.h"
+
+class ComposeTest
+{
+public:
+    static int run(uint lines)
+    {
+        #if SIMD_ENABLED
+        config.video_layers = 0b11111;
+        Color::init(false);
+
+        uint failures = 0;
+
+        for (uint line = 0; line < lines; ++line)
+        {
+            randomize();
+
+            ppu.compose(0xF, false);
+            const auto expected = video_ctx.scanline(ppu.vcount);
+
+            ppu.compose(0xF, true);
+            const auto& actual = video_ctx.scanline(ppu.vcount);
+
+            if (!std::equal(expected.begin(), expected.end(), actual.begin()) && failures++ < 8)
+                shell::print("Line {} differs (blend mode {})\n", line, ppu.bldcnt.mode);
+        }
+
+        shell::print("{} of {} lines differ\n", failures, lines);
+
+        return failures != 0;
+        #else
+        shell::print("SIMD compositor not enabled\n");
+
+        return 0;
+        #endif
+    }
+
+private:
+    static uint random(uint range)
+    {
+        return rng() % range;
+    }
+
+    static u16 color()
+    {
+        return random(3) == 0 ? kTransparent : random(0x8000);
+    }
+
+    static void randomize()
+    {
+        ppu.vcount = random(kScreenH);
+
+        ppu.dispcnt.write(0, 0);
+        ppu.dispcnt.write(1, random(256));
+        ppu.bldcnt.write(0, random(256));
+        ppu.bldcnt.write(1, random(64));
+        ppu.bldalpha.write(0, random(32));
+        ppu.bldalpha.write(1, random(32));
+        ppu.bldfade.write(0, random(32));
+        ppu.winin.write(0, random(64));
+        ppu.winin.write(1, random(64));
+        ppu.winout.write(0, random(64));
+        ppu.winout.write(1, random(64));
+
+        for (uint x = 0; x < 2; ++x)
+        {
+            ppu.winh[x].write(0, random(256));
+            ppu.winh[x].write(1, random(256));
+            ppu.winv[x].write(0, random(256));
+            ppu.winv[x].write(1, random(256));
+        }
+
+        ppu.pram.writeHalf(0, random(0x10000));
+
+        for (auto& background : ppu.backgrounds)
+        {
+            background.control.write(0, random(256));
+
+            for (auto& pixel : background.buffer)
+                pixel = color();
+        }
+
+        ppu.objects_exist = random(4) != 0;
+        ppu.objects_alpha = false;
+
+        for (auto& object : ppu.objects)
+        {
+            object.color    = color();
+            object.priority = random(4);
+            object.alpha    = ppu.objects_exist && random(4) == 0;
+            object.window   = random(2);
+
+            ppu.objects_alpha |= object.alpha;
+        }
+    }
+
+    inline static std::mt19937 rng{ 0 };
+};
+
+int main()
+{
+    return ComposeTest::run(200'000);
+}
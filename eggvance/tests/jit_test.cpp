@@ -0,0 +1,166 @@
+#include <shell/format.h>
+
+#include "arm/arm.h"
+#include "base/config.h"
+#include "scheduler/scheduler.h"
+
+class JitTest
+{
+public:
+    JitTest()
+    {
+        irq.bind<&JitTest::onIrq>(this);
+    }
+
+    int run()
+    {
+        if (!Jit::isSupported())
+        {
+            shell::print("JIT not supported\n");
+
+            return 0;
+        }
+
+        for (u16 x = 0; x < kAdds; ++x)
+            arm.iwram->writeFast<u16>(2 * x, 0x3001);                    // adds r0, 1
+        arm.iwram->writeFast<u16>(2 * kAdds, 0xE000 | (0x7FE - kAdds));  // b    0
+
+        arm.init();
+        config.idle_loops = false;
+
+        uint failures = 0;
+
+        for (uint delay = 1; delay < kAdds; ++delay)
+        {
+            config.jit = false;
+            u32 expected = latency(delay);
+
+            config.jit = true;
+            for (uint x = 0; x < 2 * Jit::kThreshold; ++x)
+                latency(0);
+            u32 actual = latency(delay);
+
+            if (actual != expected && failures++ < 8)
+                shell::print("IRQ after {} cycles taken at r0 {} instead of {}\n", delay, actual, expected);
+        }
+
+        shell::print("{} of {} IRQ delays differ\n", failures, kAdds - 1);
+
+        uint mismatches = 0;
+
+        for (uint program = 0; program < kPrograms; ++program)
+        {
+            generate();
+
+            config.jit = false;
+            State expected = execute();
+
+            config.jit = true;
+            for (uint x = 0; x < 2 * Jit::kThreshold; ++x)
+                execute();
+            State actual = execute();
+
+            if (actual != expected && mismatches++ < 8)
+                shell::print("ARM program {} differs in registers or flags\n", program);
+        }
+
+        shell::print("{} of {} ARM programs differ\n", mismatches, kPrograms);
+
+        return failures != 0 || mismatches != 0;
+    }
+
+private:
+    static constexpr u16 kAdds = 32;
+    static constexpr uint kLength = 24;
+    static constexpr uint kPrograms = 256;
+    static constexpr u32 kProgram = 0x0300'1000;
+
+    using State = shell::array<u32, 9>;
+
+    void onIrq(u64 late)
+    {
+        arm.state |= Arm::State::Irq;
+    }
+
+    u32 latency(u64 delay)
+    {
+        arm.switchMode(Psr::Mode::Sys);
+        arm.cpsr = uint(Psr::Mode::Sys) | 1 << 5;
+        arm.state = uint(Arm::State::Thumb);
+        arm.regs[0] = 0;
+        arm.pc = 0x0300'0000;
+        arm.flushHalf();
+        arm.pc += 2;
+
+        if (delay)
+            scheduler.insert(irq, delay);
+
+        arm.target = scheduler.now();
+        arm.run(kAdds + 8);
+
+        return arm.cpsr.m == Psr::Mode::Irq ? arm.regs[0] : -1;
+    }
+
+    u32 random()
+    {
+        seed = seed * 1103515245 + 12345;
+        return seed >> 16;
+    }
+
+    void generate()
+    {
+        for (uint x = 0; x < kLength; ++x)
+        {
+            u32 opcode = random() & 0xF;
+            u32 flags  = (opcode >> 2) == 0b10 || random() & 0x1;
+            u32 cond   = random() % 4 ? 0xE : random() & 0xD;
+
+            u32 operand = random() & 0x1
+                ? 1 << 25 | (random() & 0xFFF)
+                : (random() & 0x1F) << 7 | (random() & 0x3) << 5 | (random() & 0x7);
+
+            u32 instr = cond << 28 | opcode << 21 | flags << 20 | (random() & 0x7) << 16 | (random() & 0x7) << 12 | operand;
+
+            arm.writeWord(kProgram + 4 * x, instr);
+        }
+        arm.writeWord(kProgram + 4 * kLength, 0xEAFF'FFFE);  // b .
+
+        for (u32& reg : registers)
+            reg = random() << 16 | random();
+        psr = random() << 28;
+    }
+
+    State execute()
+    {
+        arm.switchMode(Psr::Mode::Sys);
+        arm.cpsr = uint(Psr::Mode::Sys) | psr;
+        arm.state = 0;
+        for (uint x = 0; x < registers.size(); ++x)
+            arm.regs[x] = registers[x];
+        arm.pc = kProgram;
+        arm.flushWord();
+        arm.pc += 4;
+
+        arm.target = scheduler.now();
+        arm.run(2 * kLength);
+
+        State state;
+        for (uint x = 0; x < registers.size(); ++x)
+            state[x] = arm.regs[x];
+        state[8] = arm.cpsr;
+
+        return state;
+    }
+
+    Event irq;
+    u32 seed = 0;
+    u32 psr = 0;
+    shell::array<u32, 8> registers = {};
+};
+
+int main()
+{
+    JitTest test;
+
+    return test.run();
+}
@@ -0,0 +1,73 @@
+#include <chrono>
+#include <random>
+#include <shell/format.h>
+
+#include "base/config.h"
+#include "ppu/ppu.h"
+
+class ObjectsBenchmark
+{
+public:
+    static void run(uint frames)
+    {
+        using Clock = std::chrono::high_resolution_clock;
+
+        std::mt19937 rng(0);
+
+        config.video_layers = 0b11111;
+
+        ppu.writeIo(0, 0x40);
+        ppu.writeIo(1, 0x11);
+
+        for (u32 addr = kObjectBase; addr < ppu.vram.size(); addr += 2)
+            ppu.vram.writeHalf(addr, rng());
+
+        for (u32 addr = 0; addr < ppu.pram.size(); addr += 2)
+            ppu.pram.writeHalf(addr, rng());
+
+        for (uint matrix = 0; matrix < 32; ++matrix)
+        {
+            ppu.oam.writeHalf(32 * matrix +  6, 0x100 + matrix);
+            ppu.oam.writeHalf(32 * matrix + 14, matrix);
+            ppu.oam.writeHalf(32 * matrix + 22, 0);
+            ppu.oam.writeHalf(32 * matrix + 30, 0x100);
+        }
+
+        const auto begin = Clock::now();
+
+        for (uint frame = 0; frame < frames; ++frame)
+        {
+            for (uint index = 0; index < 128; ++index)
+            {
+                uint y = (3 * index + frame) % 160;
+                uint x = (7 * index + 2 * frame) % 240;
+
+                uint attr0 = y | (index % 4 == 0) << 8 | (index % 8 == 1) << 13;
+                uint attr1 = x | (index % 32) << 9 | (1 + index % 3) << 14;
+                uint attr2 = (16 * index) % 1024 | (index % 4) << 10 | (index % 16) << 12;
+
+                ppu.oam.writeHalf(8 * index + 0, attr0);
+                ppu.oam.writeHalf(8 * index + 2, attr1);
+                ppu.oam.writeHalf(8 * index + 4, attr2);
+            }
+
+            for (uint line = 0; line < kScreenH; ++line)
+            {
+                ppu.vcount = line;
+                ppu.render();
+            }
+        }
+
+        const auto seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+        shell::print("{} frames in {:.2f} s - {:.1f} fps - {:.1f}% of lines reused\n",
+            frames, seconds, frames / seconds, 100.0 * ppu.lines_reused / ppu.lines_rendered);
+    }
+};
+
+int main()
+{
+    ObjectsBenchmark::run(1000);
+
+    return 0;
+}
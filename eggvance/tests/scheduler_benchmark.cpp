@@ -0,0 +1,73 @@
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+#include <shell/format.h>
+
+#include "scheduler/scheduler.h"
+
+class Source
+{
+public:
+    Source(Scheduler& scheduler, u64 period)
+        : scheduler(scheduler), period(period)
+    {
+        event.bind<&Source::onEvent>(this);
+    }
+
+    void onEvent(u64 late)
+    {
+        scheduler.insert(event, period);
+    }
+
+    Scheduler& scheduler;
+    Event event;
+    u64 period;
+};
+
+static void benchmark(uint count, u64 cycles)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    std::mt19937 rng(count);
+    Scheduler scheduler;
+
+    std::vector<std::unique_ptr<Source>> sources;
+    for (uint x = 0; x < count; ++x)
+    {
+        auto& source = sources.emplace_back(std::make_unique<Source>(scheduler, 16 + rng() % 1232));
+        scheduler.insert(source->event, 1 + rng() % 1232);
+    }
+
+    u64 reschedules = 0;
+
+    const auto begin = Clock::now();
+
+    while (scheduler.now() < cycles)
+    {
+        scheduler.run(1 + rng() % 8);
+
+        if (rng() % 64 == 0)
+        {
+            auto& source = *sources[rng() % count];
+            scheduler.remove(source.event);
+            scheduler.insert(source.event, 1 + rng() % 1232);
+            reschedules++;
+        }
+    }
+
+    const auto seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    shell::print("{:2} events - {} reschedules in {:.3f} s - {:.1f} M cycles/s\n",
+        count, reschedules, seconds, cycles / seconds / 1'000'000);
+}
+
+int main()
+{
+    constexpr u64 kCycles = 100'000'000;
+
+    for (uint count : { 8, 12, 16, 20 })
+        benchmark(count, kCycles);
+
+    return 0;
+}